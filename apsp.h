@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Kürzeste Wege zwischen allen Knotenpaaren
+ */
+
+// Ergebnis von apsp und johnson: Dichte Distanzmatrix über den
+// Knotenindizes 0 bis n - 1 eines FrozenGraph (bzw. über den Knoten in
+// der Reihenfolge von g.vertices()).
+// Die Zeilen sind auf stride Einträge aufgefüllt; dist[i * stride + j]
+// ist die Distanz von i nach j (unendlich, wenn j von i aus nicht
+// erreichbar ist), pred[i * stride + j] der Vorgänger von j auf einem
+// kürzesten Weg von i nach j (NONE, wenn es keinen gibt).
+// (pred ist leer, wenn keine Vorgänger angefordert wurden.)
+struct DistMatrix {
+    uint n = 0, stride = 0;
+    vector<double> dist;
+    vector<uint> pred;
+
+    // Matrix für n Knoten mit Zeilenlänge stride anlegen; alle
+    // Distanzen unendlich, alle Vorgänger NONE.
+    void init (uint n, uint stride, bool preds) {
+        this->n = n;
+        this->stride = stride;
+        dist.assign(size_t(n) * stride, numeric_limits<double>::infinity());
+        pred.clear();
+        if (preds) pred.assign(size_t(n) * stride, NONE);
+    }
+
+    // Distanz bzw. Vorgänger für das Paar (i, j) liefern
+    // (Vorgänger NONE, wenn keine Vorgänger angefordert wurden).
+    double distance (uint i, uint j) const {
+        return dist[size_t(i) * stride + j];
+    }
+    uint predecessor (uint i, uint j) const {
+        return pred.empty() ? NONE : pred[size_t(i) * stride + j];
+    }
+
+    // Kürzesten Weg von i nach j in p speichern
+    // (leer, wenn j von i aus nicht erreichbar ist oder keine Vorgänger
+    // angefordert wurden).
+    void path (uint i, uint j, vector<uint>& p) const {
+        p.clear();
+        if (pred.empty()) return;
+        if (distance(i, j) == numeric_limits<double>::infinity()) return;
+        for (uint v = j; v != i; v = predecessor(i, v)) p.push_back(v);
+        p.push_back(i);
+        reverse(p.begin(), p.end());
+    }
+};
+
+// Blockgröße des blockweisen Floyd-Warshall.
+// Drei Blöcke mit 64 x 64 Distanzen (und ggf. Vorgängern) passen
+// gemeinsam in den L2-Cache.
+constexpr uint FW_BLOCK = 64;
+
+// Min-Plus-Produkt eines Blockpaares in den Block C einrechnen:
+// C[i][j] = min(C[i][j], A[i][k] + B[k][j]) für alle i, j, k eines
+// Blocks, wobei die Zeilen aller drei Blöcke stride Einträge
+// auseinanderliegen. Mit P = true werden die Vorgänger PC aus PB
+// mitgeführt.
+// Die k-Schleife liegt außen, damit der Kern auch dann korrekt ist,
+// wenn A, B und C derselbe Block sind (Phase 1 und 2).
+// Die innerste Schleife ist verzweigungsfrei und wird vom Compiler
+// (ab -O2 bzw. -O3) zu SIMD-Befehlen vektorisiert.
+template <bool P>
+inline void minPlus (double* C, uint* PC, const double* A,
+                     const double* B, const uint* PB, size_t stride) {
+    for (uint k = 0; k < FW_BLOCK; k++) {
+        const double* b = B + k * stride;
+        const uint* pb = P ? PB + k * stride : nullptr;
+        for (uint i = 0; i < FW_BLOCK; i++) {
+            double a = A[i * stride + k];
+            if (a == numeric_limits<double>::infinity()) continue;
+            double* c = C + i * stride;
+            uint* pc = P ? PC + i * stride : nullptr;
+            for (uint j = 0; j < FW_BLOCK; j++) {
+                double x = a + b[j];
+                bool better = x < c[j];
+                c[j] = better ? x : c[j];
+                if (P) pc[j] = better ? pb[j] : pc[j];
+            }
+        }
+    }
+}
+
+// Blockweiser Floyd-Warshall auf der (bereits initialisierten)
+// Matrix res.
+// Für jeden Diagonalblock kk werden nacheinander
+// 1. der Diagonalblock selbst,
+// 2. alle übrigen Blöcke in Blockzeile und Blockspalte kk (parallel),
+// 3. alle restlichen Blöcke (parallel)
+// aktualisiert.
+template <bool P>
+void floydWarshall (DistMatrix& res, ThreadPool& pool) {
+    size_t s = res.stride;
+    uint nb = s / FW_BLOCK;
+    auto block = [&] (uint bi, uint bj) {
+        return size_t(bi) * FW_BLOCK * s + size_t(bj) * FW_BLOCK;
+    };
+    auto update = [&] (uint bi, uint bj, uint bk) {
+        size_t c = block(bi, bj), a = block(bi, bk), b = block(bk, bj);
+        minPlus<P>(&res.dist[c], P ? &res.pred[c] : nullptr, &res.dist[a],
+                   &res.dist[b], P ? &res.pred[b] : nullptr, s);
+    };
+
+    for (uint k = 0; k < nb; k++) {
+        update(k, k, k);
+        pool.parallelFor(2 * nb, [&] (size_t x, uint) {
+            uint o = x / 2;
+            if (o == k) return;
+            if (x % 2) update(k, o, k);
+            else update(o, k, k);
+        });
+        pool.parallelFor(size_t(nb) * nb, [&] (size_t x, uint) {
+            uint i = x / nb, j = x % nb;
+            if (i != k && j != k) update(i, j, k);
+        });
+    }
+}
+
+// Kürzeste Wege zwischen allen Knotenpaaren des Graphen g mit einem
+// blockweisen, parallelen Floyd-Warshall ermitteln und das Ergebnis
+// in res speichern (mit Vorgängern, falls preds true ist).
+// Die Kanten dürfen negative Gewichte besitzen.
+// Resultatwert true, wenn es keinen Zyklus mit negativem Gewicht
+// gibt, andernfalls false.
+// (Im zweiten Fall darf der Inhalt von res danach undefiniert sein.)
+// Laufzeit O(n^3), Speicher O(n^2): gedacht für dichte Graphen mit
+// bis zu einigen tausend Knoten.
+template <typename V>
+bool apsp (const FrozenGraph<V>& g, DistMatrix& res, bool preds = true,
+           ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    uint stride = (n + FW_BLOCK - 1) / FW_BLOCK * FW_BLOCK;
+
+    // Auffüllzeilen und -spalten bleiben unendlich und verändern
+    // deshalb keine echte Distanz.
+    res.init(stride, stride, preds);
+    for (uint u = 0; u < n; u++) {
+        res.dist[size_t(u) * stride + u] = 0;
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            size_t x = size_t(u) * stride + g.tgt[e];
+            if (g.weight(e) < res.dist[x]) {
+                res.dist[x] = g.weight(e);
+                if (preds) res.pred[x] = u;
+            }
+        }
+    }
+
+    if (preds) floydWarshall<true>(res, pool);
+    else floydWarshall<false>(res, pool);
+    res.n = n;
+
+    for (uint u = 0; u < n; u++) {
+        if (res.distance(u, u) < 0) return false;
+    }
+    return true;
+}
+
+// Kürzeste Wege zwischen allen Knotenpaaren des gewichteten Graphen g
+// ermitteln (siehe oben). Die Knotenindizes von res entsprechen der
+// Reihenfolge von g.vertices().
+template <typename V>
+bool apsp (WeightedGraph<V>& g, DistMatrix& res, bool preds = true,
+           ThreadPool& pool = defaultPool()) {
+    return apsp(freeze(g), res, preds, pool);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Stapelverarbeitung vieler unabhängiger Suchen
+ */
+
+// Für jeden Startknoten sources[k] (Index) eine Suche search(g, s, ws)
+// im Graphen g ausführen und danach f(k, ws) aufrufen.
+// Die Suchen laufen parallel auf den Threads des Pools pool; jeder
+// Thread besitzt einen eigenen Arbeitsspeicher, der für alle seine
+// Suchen wiederverwendet wird und während des Aufrufs von f das
+// Ergebnis der Suche enthält.
+// f wird nebenläufig aus mehreren Threads aufgerufen und muss daher
+// entweder in disjunkte Bereiche (etwa Zeile k einer Matrix) schreiben
+// oder selbst synchronisieren.
+template <typename V, typename S, typename F>
+void searchMany (const FrozenGraph<V>& g, const vector<uint>& sources,
+                 S search, F f, ThreadPool& pool) {
+    vector<Workspace> ws(pool.size());
+    pool.parallelFor(sources.size(), [&] (size_t k, uint w) {
+        search(g, sources[k], ws[w]);
+        f(k, const_cast<const Workspace&>(ws[w]));
+    });
+}
+
+// Dijkstra von allen Startknoten sources (Indizes) aus parallel
+// ausführen und jeweils f(k, ws) aufrufen (siehe searchMany).
+template <typename V, typename F>
+void dijkstraMany (const FrozenGraph<V>& g, const vector<uint>& sources,
+                   F f, ThreadPool& pool = defaultPool()) {
+    searchMany(g, sources, [] (const FrozenGraph<V>& g, uint s,
+                               Workspace& ws) { dijkstra(g, s, ws); },
+               f, pool);
+}
+
+// Breitensuche von allen Startknoten sources (Indizes) aus parallel
+// ausführen und jeweils f(k, ws) aufrufen (siehe searchMany).
+template <typename V, typename F>
+void bfsMany (const FrozenGraph<V>& g, const vector<uint>& sources,
+              F f, ThreadPool& pool = defaultPool()) {
+    searchMany(g, sources, [] (const FrozenGraph<V>& g, uint s,
+                               Workspace& ws) { bfs(g, s, ws); },
+               f, pool);
+}
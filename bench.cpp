@@ -0,0 +1,253 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+#include "graph.h"
+#include "csr.h"
+#include "hugepage.h"
+#include "numa.h"
+#include "threadpool.h"
+
+// Zufälligen gewichteten Graphen mit n Knoten und durchschnittlich
+// degree Nachfolgern je Knoten direkt im CSR-Format erzeugen.
+// (Ohne Tabelle idx, weil die Messungen nur mit Indizes arbeiten.)
+FrozenGraph<uint> randomGraph (uint n, uint degree, uint seed = 1) {
+    mt19937 rng(seed);
+    FrozenGraph<uint> g;
+    g.vs.resize(n);
+    g.off.assign(n + 1, 0);
+    for (uint v = 0; v < n; v++) {
+        g.vs[v] = v;
+        g.off[v + 1] = g.off[v] + rng() % (2 * degree + 1);
+    }
+    g.tgt.resize(g.off[n]);
+    g.wt.resize(g.off[n]);
+    for (uint e = 0; e < g.off[n]; e++) {
+        g.tgt[e] = rng() % n;
+        g.wt[e] = 1 + rng() % 100;
+    }
+    return g;
+}
+
+// Verstrichene Zeit seit t in Millisekunden.
+double millis (chrono::steady_clock::time_point t) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t)
+           .count();
+}
+
+// Hardwarezähler des aufrufenden Threads über perf_event_open (nur
+// Benutzermodus). Ist der Zähler nicht verfügbar (z. B. in virtuellen
+// Maschinen oder bei zu strengem perf_event_paranoid), liefert read -1.
+struct PerfCounter {
+    int fd = -1;
+
+    PerfCounter (uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    ~PerfCounter () { if (fd >= 0) close(fd); }
+
+    PerfCounter (const PerfCounter&) = delete;
+    PerfCounter& operator= (const PerfCounter&) = delete;
+
+    void start () {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    long long stop () {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long v;
+        return ::read(fd, &v, sizeof(v)) == sizeof(v) ? v : -1;
+    }
+};
+
+// Ereignis für PerfCounter: Fehlzugriffe auf den Daten-TLB
+// (Lesezugriffe).
+constexpr uint64_t TLB_MISSES = PERF_COUNT_HW_CACHE_DTLB
+                                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+// Zählerstand c ausgeben (oder "n. v.", wenn nicht verfügbar).
+string count (long long c) {
+    return c < 0 ? "n. v." : to_string(c);
+}
+
+// Pull-Iteration im Stil von PageRank über den transponierten Graphen t:
+// next[v] = Summe von rank[u] * inv[u] über alle Kanten (u, v).
+// Jeder Thread liest dabei seine Knoten und Kanten sequenziell und die
+// Ränge der Vorgänger verstreut.
+void pull (const FrozenGraph<uint>& t, const vector<double>& rank,
+           const vector<double>& inv, vector<double>& next, ThreadPool& pool) {
+    pool.parallelRange(t.size(), [&] (size_t b, size_t e, uint) {
+        for (size_t v = b; v < e; v++) {
+            double s = 0;
+            for (uint x = t.off[v]; x < t.off[v + 1]; x++) {
+                s += rank[t.tgt[x]] * inv[t.tgt[x]];
+            }
+            next[v] = s;
+        }
+    }, 4096);
+}
+
+// NUMA-Messung: Dieselbe Pull-Iteration mit
+// 1. allen Feldern dort, wo sie der Hauptthread angelegt hat, und
+//    ungebundenen Threads,
+// 2. auf alle Knoten verteilten Seiten (PLACE_INTERLEAVE),
+// 3. gebundenen Threads und Feldern, deren Teile auf dem Knoten des
+//    jeweils bearbeitenden Threads liegen (PLACE_PARTITIONED).
+// Auf einem Rechner mit zwei Sockeln liegt bei 1. die Hälfte der
+// Zugriffe auf entferntem Speicher; 3. sollte dann deutlich schneller
+// sein als 1., 2. dazwischen.
+void benchNuma (uint n, uint degree, uint iterations, uint threads) {
+    NumaTopology topo;
+    cout << "NUMA-Knoten: " << topo.nodes() << ", Threads: " << threads << endl;
+    for (uint k = 0; k < topo.nodes(); k++) {
+        cout << "  Knoten " << topo.ids[k] << ": " << topo.cpus[k].size()
+             << " Prozessoren" << endl;
+    }
+
+    const char* names[] = { "Erstzugriff (Hauptthread)", "verschränkt",
+                            "partitioniert + gebunden" };
+    for (Placement p : { PLACE_DEFAULT, PLACE_INTERLEAVE, PLACE_PARTITIONED }) {
+        ThreadPool pool(threads);
+        if (p == PLACE_PARTITIONED && !pool.pin(topo.assign(threads))) {
+            cout << "  (Threads konnten nicht gebunden werden)" << endl;
+        }
+        FrozenGraph<uint> t = randomGraph(n, degree).transpose();
+        vector<double> rank(n, 1.0 / n), inv(n, 1), next(n, 0);
+        bool ok = place(t, p, topo, threads);
+        ok = place(rank, p, topo, threads) && ok;
+        ok = place(inv, p, topo, threads) && ok;
+        ok = place(next, p, topo, threads) && ok;
+
+        pull(t, rank, inv, next, pool);
+        auto start = chrono::steady_clock::now();
+        for (uint i = 0; i < iterations; i++) {
+            pull(t, rank, inv, next, pool);
+            rank.swap(next);
+        }
+        double ms = millis(start) / iterations;
+        cout << "  " << names[p] << ": " << ms << " ms je Iteration, "
+             << t.edges() / ms / 1e6 << " Mrd. Kanten/s"
+             << (ok ? "" : " (Platzierung abgelehnt)") << endl;
+    }
+}
+
+// Messung großer Seiten: Breitensuche und Dijkstra von sources
+// zufälligen Startknoten aus, jeweils mit Graph und Arbeitsspeicher mit
+// gewöhnlichen Seiten, transparenten großen Seiten sowie expliziten 2-MB-
+// und 1-GB-Seiten angelegt. Für jede Einstellung werden Laufzeit und
+// TLB-Fehlzugriffe sowie die tatsächlich erhaltene Seitenart
+// ausgegeben (fehlende explizite Seiten fallen auf schwächere Arten
+// zurück).
+void benchHuge (uint n, uint degree, uint sources) {
+    const char* names[] = { "4 KB", "THP", "2 MB", "1 GB" };
+    for (int mode : { HUGE_OFF, HUGE_THP, HUGE_2MB, HUGE_1GB }) {
+        hugePages() = mode;
+        FrozenGraph<uint> g = randomGraph(n, degree);
+        Workspace ws;
+        ws.reset(n);
+        HugeRegistry& r = HugeRegistry::get();
+        cout << names[mode] << " (erhalten:";
+        if (mode == HUGE_OFF) cout << " 4 KB";
+        for (int k = HUGE_OFF; k <= HUGE_1GB; k++) {
+            if (r.bytes[k]) cout << " " << names[k] << " " << (r.bytes[k] >> 20) << " MB";
+        }
+        cout << ")" << endl;
+
+        mt19937 rng(2);
+        for (int kind = 0; kind < 2; kind++) {
+            PerfCounter tlb(PERF_TYPE_HW_CACHE, TLB_MISSES);
+            auto start = chrono::steady_clock::now();
+            tlb.start();
+            for (uint i = 0; i < sources; i++) {
+                if (kind == 0) bfs(g, uint(rng() % n), ws);
+                else dijkstra(g, uint(rng() % n), ws);
+            }
+            long long misses = tlb.stop();
+            cout << "  " << (kind == 0 ? "bfs:      " : "dijkstra: ")
+                 << millis(start) / sources << " ms je Suche, TLB-Fehlzugriffe: "
+                 << count(misses) << endl;
+        }
+    }
+    hugePages() = HUGE_OFF;
+}
+
+// Messung des Vorausladens: Breitensuche und Dijkstra von denselben
+// sources zufälligen Startknoten aus mit verschiedenen Werten von
+// prefetchDistance() (0 = ohne Vorausladen). Der Graph sollte deutlich
+// größer als der Cache der letzten Stufe sein (Voreinstellung: 4 Mio.
+// Knoten, 64 Mio. Kanten).
+void benchPrefetch (uint n, uint degree, uint sources) {
+    FrozenGraph<uint> g = randomGraph(n, degree);
+    Workspace ws;
+    ws.reset(n);
+    uint old = prefetchDistance();
+    cout << "Abstand   bfs (ms)   dijkstra (ms)" << endl;
+    for (uint d : { 0, 1, 2, 4, 8, 16, 32, 64 }) {
+        prefetchDistance() = d;
+        cout << d;
+        for (int kind = 0; kind < 2; kind++) {
+            mt19937 rng(3);
+            auto start = chrono::steady_clock::now();
+            for (uint i = 0; i < sources; i++) {
+                if (kind == 0) bfs(g, uint(rng() % n), ws);
+                else dijkstra(g, uint(rng() % n), ws);
+            }
+            cout << "\t" << millis(start) / sources;
+        }
+        cout << endl;
+    }
+    prefetchDistance() = old;
+}
+
+void usage () {
+    cerr << "Aufruf:" << endl
+         << "  Algo_U3_bench numa [n] [Grad] [Iterationen] [Threads]" << endl
+         << "  Algo_U3_bench huge [n] [Grad] [Startknoten]" << endl
+         << "  Algo_U3_bench prefetch [n] [Grad] [Startknoten]" << endl;
+}
+
+int main (int argc, char* argv[]) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    string mode = argv[1];
+    uint n = argc > 2 ? atoi(argv[2]) : 1 << 22;
+    uint degree = argc > 3 ? atoi(argv[3]) : 16;
+    uint iterations = argc > 4 ? atoi(argv[4]) : 10;
+    uint threads = argc > 5 ? atoi(argv[5])
+                            : max(1u, thread::hardware_concurrency());
+    if (mode == "numa") {
+        benchNuma(n, degree, iterations, threads);
+    } else if (mode == "huge") {
+        benchHuge(n, degree, iterations);
+    } else if (mode == "prefetch") {
+        benchPrefetch(n, degree, iterations);
+    } else {
+        usage();
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <utility>	// pair
+
+#include "graph.h"
+
+/*
+ *  Artikulationspunkte, Brücken und Zweifachzusammenhangskomponenten
+ */
+
+// Ergebnis von biconnected: Erweiterung des Ergebnisses einer
+// Tiefensuche (det, fin, color_map und seq werden wie bei dfs gefüllt)
+// um die Low-Werte und die daraus abgeleiteten Strukturen.
+template <typename V>
+struct BCC : DFS<V> {
+    // low[v] ist die kleinste Entdeckungszeit, die vom Teilbaum unter v
+    // aus über höchstens eine Rückwärtskante erreichbar ist.
+    map<V, uint> low;
+
+    // Artikulationspunkte (Knoten, deren Entfernen den Graphen weiter
+    // zerfallen lässt) und Brücken (Kanten mit derselben Eigenschaft).
+    list<V> articulation;
+    list<pair<V, V>> bridges;
+
+    // Zweifachzusammenhangskomponenten als Listen ihrer Kanten
+    // (jede Kante genau einmal, in Richtung der Tiefensuche).
+    list<list<pair<V, V>>> components;
+};
+
+// Artikulationspunkte, Brücken und Zweifachzusammenhangskomponenten des
+// ungerichteten Graphen g (jede Kante in beiden Richtungen vorhanden)
+// mit dem Algorithmus von Hopcroft und Tarjan in einem einzigen
+// Tiefensuchdurchlauf ermitteln und das Ergebnis in res speichern.
+// Die Tiefensuche ist iterativ (mit einem expliziten Stapel statt
+// Rekursion wie in DFSVisit) und funktioniert daher auch bei sehr
+// tiefen Graphen. Wie bei dfs werden die Knoten in der Hauptschleife
+// in der Reihenfolge von g.vertices() durchlaufen.
+// Mehrfachkanten werden korrekt behandelt: Nur ein Vorkommen der
+// Kante zum Elternknoten wird als Baumkante übersprungen.
+template <typename V, typename G>
+void biconnected (G g, BCC<V>& res) {
+    using DFS = ::DFS<V>;
+
+    // Stapeleintrag: Knoten, Elternknoten, noch nicht durchlaufene
+    // Nachfolger und Anzahl der Kinder im DFS-Baum.
+    struct Frame {
+        V v, parent;
+        bool root, skipped;
+        list<V> succ;
+        typename list<V>::iterator it;
+        uint children;
+    };
+
+    for (auto v : g.vertices()) {
+        res.color_map[v] = DFS::WHITE;
+        res.det[v] = 0;
+        res.fin[v] = 0;
+    }
+
+    uint time = 0;
+    map<V, bool> cut;
+    list<pair<V, V>> edges;
+    list<Frame> stack;
+
+    // Knoten v mit Elternknoten p entdecken.
+    auto discover = [&] (V v, V p, bool root) {
+        res.color_map[v] = DFS::GRAY;
+        res.det[v] = res.low[v] = ++time;
+        stack.push_back({ v, p, root, false, g.successors(v), {}, 0 });
+        stack.back().it = stack.back().succ.begin();
+    };
+
+    for (auto s : g.vertices()) {
+        if (res.color_map[s] != DFS::WHITE) continue;
+        discover(s, s, true);
+
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            V u = f.v;
+            if (f.it != f.succ.end()) {
+                V w = *f.it++;
+                if (!f.root && !f.skipped && w == f.parent) {
+                    f.skipped = true;
+                } else if (res.color_map[w] == DFS::WHITE) {
+                    f.children++;
+                    edges.push_back({ u, w });
+                    discover(w, u, false);
+                } else if (res.det[w] < res.det[u]) {
+                    // Rückwärtskante zu einem Vorfahren.
+                    edges.push_back({ u, w });
+                    res.low[u] = min(res.low[u], res.det[w]);
+                }
+                continue;
+            }
+
+            // Knoten u ist abgeschlossen.
+            res.color_map[u] = DFS::BLACK;
+            res.fin[u] = ++time;
+            res.seq.push_back(u);
+            bool root = f.root;
+            uint children = f.children;
+            V p = f.parent;
+            stack.pop_back();
+
+            if (root) {
+                if (children >= 2) res.articulation.push_back(u);
+                continue;
+            }
+
+            res.low[p] = min(res.low[p], res.low[u]);
+            if (res.low[u] >= res.det[p]) {
+                // p trennt den Teilbaum unter u ab: Kanten bis
+                // einschließlich (p, u) bilden eine Komponente.
+                if (!stack.back().root && !cut[p]) {
+                    cut[p] = true;
+                    res.articulation.push_back(p);
+                }
+                list<pair<V, V>> c;
+                for (;;) {
+                    pair<V, V> e = edges.back();
+                    edges.pop_back();
+                    c.push_front(e);
+                    if (e.first == p && e.second == u) break;
+                }
+                res.components.push_back(c);
+            }
+            if (res.low[u] > res.det[p]) res.bridges.push_back({ p, u });
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.h"
+
+// Bitmenge über den Zahlen 0 bis n - 1, gespeichert in 64-Bit-Wörtern.
+// (Im Gegensatz zu std::bitset ist die Größe erst zur Laufzeit bekannt,
+// und im Gegensatz zu vector<bool> ist der Zugriff auf ganze Wörter
+// möglich, etwa für wortweise Vereinigungen.)
+struct Bitset {
+    vector<uint64_t> words;
+
+    Bitset (uint n = 0) : words((size_t(n) + 63) / 64, 0) {}
+
+    // Größe auf n Elemente ändern und alle Elemente entfernen.
+    void assign (uint n) { words.assign((size_t(n) + 63) / 64, 0); }
+
+    bool test (uint i) const { return words[i >> 6] >> (i & 63) & 1; }
+    void set (uint i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset (uint i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+};
+
+// Farben (WHITE, GRAY, BLACK wie bei DFS<V>) der Zahlen 0 bis n - 1 mit
+// zwei Bits je Element, 32 Elemente je 64-Bit-Wort.
+struct ColorMap {
+    vector<uint64_t> words;
+
+    ColorMap (uint n = 0) : words((size_t(n) + 31) / 32, 0) {}
+
+    // Größe auf n Elemente ändern und alle auf WHITE (0) setzen.
+    void assign (uint n) { words.assign((size_t(n) + 31) / 32, 0); }
+
+    uint get (uint i) const { return words[i >> 5] >> ((i & 31) * 2) & 3; }
+    void set (uint i, uint c) {
+        uint s = (i & 31) * 2;
+        uint64_t& w = words[i >> 5];
+        w = (w & ~(uint64_t(3) << s)) | (uint64_t(c) << s);
+    }
+};
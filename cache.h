@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>	// pair
+#include <vector>
+
+#include "csr.h"
+
+/*
+ *  Zwischenspeicher für Bäume kürzester Wege
+ */
+
+// Kompakt gespeichertes Ergebnis einer vollständigen Suche (dijkstra
+// oder bfs) vom Startknoten source aus.
+// Gespeichert werden nur flache Felder über den Knotenindizes: die
+// Vorgänger und bei Dijkstra die Distanzen. Bei der Breitensuche (hops)
+// ergibt sich die Distanz aus der Länge des Weges zum Startknoten und
+// wird daher nicht gespeichert.
+struct PathTree {
+    uint source;
+    bool hops;
+    vector<uint> pred;
+    vector<double> dist;
+
+    // Baum aus dem Ergebnis der Suche in ws auf einem Graphen mit n
+    // Knoten übernehmen.
+    PathTree (const Workspace& ws, uint n, uint source, bool hops)
+            : source(source), hops(hops), pred(n, NONE) {
+        if (!hops) dist.assign(n, numeric_limits<double>::infinity());
+        for (uint v : ws.queue) {
+            pred[v] = ws.pred[v];
+            if (!hops) dist[v] = ws.dist[v];
+        }
+    }
+
+    // Wurde der Knoten mit Index v erreicht?
+    bool reached (uint v) const { return v == source || pred[v] != NONE; }
+
+    // Distanz des Knotens mit Index v liefern.
+    double distance (uint v) const {
+        if (!reached(v)) return numeric_limits<double>::infinity();
+        if (!hops) return dist[v];
+        uint d = 0;
+        for (; v != source; v = pred[v]) d++;
+        return d;
+    }
+
+    // Weg vom Startknoten zum Knoten mit Index t in p speichern
+    // (leer, wenn t nicht erreicht wurde).
+    void path (uint t, vector<uint>& p) const {
+        p.clear();
+        if (!reached(t)) return;
+        for (uint v = t; v != NONE; v = pred[v]) p.push_back(v);
+        reverse(p.begin(), p.end());
+    }
+
+    // Belegter Speicher in Bytes.
+    size_t bytes () const {
+        return sizeof(*this) + pred.capacity() * sizeof(uint)
+               + dist.capacity() * sizeof(double);
+    }
+};
+
+// Baum t des Graphen g als Ergebnis von dijkstra bzw. bfs in res
+// speichern.
+template <typename V, typename R>
+void result (const FrozenGraph<V>& g, const PathTree& t, R& res) {
+    for (uint v = 0; v < g.size(); v++) {
+        V x = g.vertex(v);
+        res.pred[x] = t.pred[v] == NONE ? res.NIL : g.vertex(t.pred[v]);
+        if (t.reached(v)) res.dist[x] = t.distance(v);
+        else res.dist[x] = res.INF;
+    }
+}
+
+// Zwischenspeicher für die Bäume häufig angefragter Startknoten.
+// Schlüssel ist der Startknoten (Index) zusammen mit der Art der Suche;
+// alle Einträge gehören zur Version version des Graphen. Wird ein Baum
+// für eine neuere Version angefordert, ist der Graph inzwischen
+// verändert worden (z. B. DynamicGraph::version) und der ganze
+// Zwischenspeicher wird verworfen. Anfragen für eine ältere Version
+// (etwa von einem noch laufenden Aufruf auf einem alten Schnappschuss)
+// werden ohne den Zwischenspeicher beantwortet.
+// Passen die Bäume nicht mehr in budget Bytes, werden die am längsten
+// nicht mehr benutzten verdrängt (LRU: lru ist nach der letzten
+// Benutzung geordnet, die jüngste vorne).
+// Alle Operationen dürfen nebenläufig aufgerufen werden. Die Bäume
+// werden als shared_ptr herausgegeben und bleiben daher gültig, auch
+// wenn sie inzwischen verdrängt wurden.
+struct TreeCache {
+    typedef pair<uint, bool> Key;
+    struct Item {
+        Key key;
+        shared_ptr<const PathTree> tree;
+        size_t bytes;
+    };
+
+    size_t budget, used = 0;
+    uint64_t version = 0, hits = 0, misses = 0;
+    list<Item> lru;
+    map<Key, list<Item>::iterator> index;
+    mutex lock;
+
+    explicit TreeCache (size_t budget) : budget(budget) {}
+
+    // Alle Einträge verwerfen und ab jetzt die Version v erwarten.
+    void invalidate (uint64_t v) {
+        lock_guard<mutex> guard(lock);
+        clear(v);
+    }
+
+    // Baum der Suche (Breitensuche, falls hops, sonst Dijkstra) vom
+    // Startknoten s (Index) im Graphen g mit der Version v liefern.
+    // Ist er nicht gespeichert, wird er mit dem Arbeitsspeicher ws
+    // berechnet (ohne den Zwischenspeicher zu sperren) und
+    // anschließend aufgenommen.
+    template <typename V>
+    shared_ptr<const PathTree> tree (const FrozenGraph<V>& g, uint64_t v,
+                                     uint s, bool hops, Workspace& ws) {
+        Key key(s, hops);
+        {
+            lock_guard<mutex> guard(lock);
+            if (v > version) clear(v);
+            auto it = v == version ? index.find(key) : index.end();
+            if (it != index.end()) {
+                hits++;
+                lru.splice(lru.begin(), lru, it->second);
+                return it->second->tree;
+            }
+            misses++;
+        }
+
+        if (hops) bfs(g, s, ws);
+        else dijkstra(g, s, ws);
+        auto t = make_shared<const PathTree>(ws, g.size(), s, hops);
+
+        lock_guard<mutex> guard(lock);
+        if (v != version || index.count(key)) return t;
+        size_t b = t->bytes();
+        if (b > budget) return t;
+        while (used + b > budget) {
+            used -= lru.back().bytes;
+            index.erase(lru.back().key);
+            lru.pop_back();
+        }
+        lru.push_front({ key, t, b });
+        index[key] = lru.begin();
+        used += b;
+        return t;
+    }
+
+    // Alle Einträge verwerfen (lock muss gehalten werden).
+    void clear (uint64_t v) {
+        lru.clear();
+        index.clear();
+        used = 0;
+        version = v;
+    }
+};
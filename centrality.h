@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Betweenness-Zentralität (Brandes)
+ */
+
+// Zwischenspeicher eines Threads für betweenness: Anzahl kürzester
+// Wege sigma und Abhängigkeiten delta je Knoten sowie die über alle
+// Startknoten des Threads aufsummierten Zentralitäten cb.
+struct BrandesSpace {
+    Workspace ws;
+    vector<double> sigma, delta, cb;
+};
+
+// Beitrag des Startknotens s (Index) zur Betweenness-Zentralität aller
+// Knoten des Graphen g mit dem Algorithmus von Brandes in b.cb
+// aufsummieren.
+// Die Suche (Breitensuche bei ungewichteten, Dijkstra bei gewichteten
+// Graphen) liefert in b.ws.queue alle erreichten Knoten nach
+// aufsteigender Distanz. Die Vorgänger eines Knotens w auf kürzesten
+// Wegen müssen nicht gespeichert werden: v ist genau dann ein solcher
+// Vorgänger, wenn die Kante (v, w) straff ist, d. h.
+// dist[v] + w(v, w) == dist[w] gilt, was sich beim Durchlaufen der
+// Nachfolger von v prüfen lässt.
+template <typename V>
+void brandes (const FrozenGraph<V>& g, uint s, BrandesSpace& b) {
+    Workspace& ws = b.ws;
+    if (g.weighted()) dijkstra(g, s, ws);
+    else bfs(g, s, ws);
+
+    auto tight = [&] (uint v, uint e) {
+        uint w = g.tgt[e];
+        return ws.seen(w) && ws.dist[v] + g.weight(e) == ws.dist[w];
+    };
+
+    for (uint v : ws.queue) b.sigma[v] = b.delta[v] = 0;
+    b.sigma[s] = 1;
+    for (uint v : ws.queue) {
+        for (uint e = g.off[v]; e < g.off[v + 1]; e++) {
+            if (tight(v, e)) b.sigma[g.tgt[e]] += b.sigma[v];
+        }
+    }
+
+    for (auto it = ws.queue.rbegin(); it != ws.queue.rend(); ++it) {
+        uint v = *it;
+        double d = 0;
+        for (uint e = g.off[v]; e < g.off[v + 1]; e++) {
+            uint w = g.tgt[e];
+            if (tight(v, e)) d += b.sigma[v] / b.sigma[w] * (1 + b.delta[w]);
+        }
+        b.delta[v] = d;
+        if (v != s) b.cb[v] += d;
+    }
+}
+
+// Betweenness-Zentralität aller Knoten des Graphen g ermitteln und in
+// out (nach Knotenindex) speichern.
+// Mit k = 0 wird von jedem Knoten aus gesucht (exakt, O(n m) bzw.
+// O(n m log n)); andernfalls nur von k zufällig gewählten Startknoten
+// (Pivots) aus, und das Ergebnis wird mit n / k hochgerechnet.
+// Die Suchen laufen parallel auf den Threads von pool, jeder Thread
+// summiert in ein eigenes Feld, das am Ende (ebenfalls parallel)
+// aufaddiert wird.
+// Bei gewichteten Graphen müssen alle Gewichte positiv sein.
+// (Bei einem ungerichteten Graphen wird jedes Knotenpaar in beiden
+// Richtungen gezählt; üblicherweise halbiert man dann die Werte.)
+template <typename V>
+void betweenness (const FrozenGraph<V>& g, vector<double>& out,
+                  uint k = 0, uint seed = 1,
+                  ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    vector<uint> sources(n);
+    for (uint s = 0; s < n; s++) sources[s] = s;
+    double scale = 1;
+    if (k > 0 && k < n) {
+        mt19937 rng(seed);
+        shuffle(sources.begin(), sources.end(), rng);
+        sources.resize(k);
+        scale = double(n) / k;
+    }
+
+    vector<BrandesSpace> bs(pool.size());
+    for (auto& b : bs) {
+        b.sigma.resize(n);
+        b.delta.resize(n);
+        b.cb.assign(n, 0);
+    }
+    pool.parallelFor(sources.size(), [&] (size_t i, uint w) {
+        brandes(g, sources[i], bs[w]);
+    });
+
+    out.assign(n, 0);
+    pool.parallelRange(n, [&] (size_t b, size_t e, uint) {
+        for (auto& t : bs) {
+            for (size_t v = b; v < e; v++) out[v] += t.cb[v];
+        }
+        for (size_t v = b; v < e; v++) out[v] *= scale;
+    }, 4096);
+}
+
+/*
+ *  PageRank
+ */
+
+// Parameter und Ergebnis von pagerank mit numerischem Typ N
+// (double oder float) für die Ränge.
+template <typename N = double>
+struct PageRank {
+    // Dämpfungsfaktor, Abbruchschranke für die Änderung (Summe der
+    // Beträge) zwischen zwei Iterationen und Höchstzahl an Iterationen.
+    double damping = 0.85, tolerance = 1e-9;
+    uint maxIter = 100;
+
+    // Knotenindizes der Teleportationsmenge für personalisierten
+    // PageRank (leer bedeutet: alle Knoten gleich wahrscheinlich).
+    // Ein mehrfach enthaltener Knoten erhält entsprechend mehr Gewicht.
+    vector<uint> teleport;
+
+    // Ränge nach Knotenindex (Summe 1), Anzahl der ausgeführten
+    // Iterationen und Änderung in der letzten Iteration.
+    vector<N> rank;
+    uint iterations = 0;
+    double residual = 0;
+};
+
+// PageRank aller Knoten des Graphen g mit den Parametern aus res
+// ermitteln und das Ergebnis in res speichern.
+// Jede Iteration ist eine Multiplikation der (dünn besetzten)
+// Übergangsmatrix mit dem Rangvektor in Pull-Richtung: Für jeden Knoten
+// v werden über die Nachfolger von v im transponierten Graphen (also
+// die Vorgänger von v in g) die Beiträge rank[u] / outdeg(u)
+// aufsummiert. Jeder Knoten schreibt dabei nur seinen eigenen Eintrag,
+// sodass die Knoten ohne Synchronisation auf die Threads von pool
+// verteilt werden können.
+// Der Rang von Knoten ohne Nachfolger wird wie die Teleportation
+// verteilt. Kantengewichte werden nicht berücksichtigt.
+template <typename V, typename N>
+void pagerank (const FrozenGraph<V>& g, PageRank<N>& res,
+               ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    res.rank.clear();
+    res.iterations = 0;
+    res.residual = 0;
+    if (n == 0) return;
+
+    FrozenGraph<V> t = g.transpose();
+    const size_t grain = 1024;
+
+    // Teleportationsverteilung.
+    vector<N> tele(n, res.teleport.empty() ? N(1.0 / n) : N(0));
+    for (uint v : res.teleport) tele[v] += N(1.0 / res.teleport.size());
+
+    vector<N> rank(tele), next(n), contrib(n);
+    vector<double> dangling(pool.size()), change(pool.size());
+    double d = res.damping;
+
+    while (res.iterations < res.maxIter) {
+        // Beiträge je Knoten und Rang der Knoten ohne Nachfolger.
+        fill(dangling.begin(), dangling.end(), 0);
+        pool.parallelRange(n, [&] (size_t b, size_t e, uint w) {
+            double x = 0;
+            for (size_t u = b; u < e; u++) {
+                uint deg = g.off[u + 1] - g.off[u];
+                if (deg == 0) x += rank[u];
+                contrib[u] = deg ? rank[u] / deg : 0;
+            }
+            dangling[w] += x;
+        }, grain);
+        double dm = 0;
+        for (double x : dangling) dm += x;
+
+        // Pull-Schritt.
+        fill(change.begin(), change.end(), 0);
+        pool.parallelRange(n, [&] (size_t b, size_t e, uint w) {
+            double c = 0;
+            for (size_t v = b; v < e; v++) {
+                double sum = 0;
+                for (uint x = t.off[v]; x < t.off[v + 1]; x++) {
+                    sum += contrib[t.tgt[x]];
+                }
+                N r = N((1 - d + d * dm) * tele[v] + d * sum);
+                c += fabs(double(r) - rank[v]);
+                next[v] = r;
+            }
+            change[w] += c;
+        }, grain);
+
+        rank.swap(next);
+        res.iterations++;
+        res.residual = 0;
+        for (double c : change) res.residual += c;
+        if (res.residual < res.tolerance) break;
+    }
+    res.rank.swap(rank);
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Union-Find
+ */
+
+// Disjunkte Mengen über den Elementen 0 bis n - 1 (sequenziell).
+// find verkürzt die Wege durch Halbieren, union hängt die Wurzel mit
+// dem größeren Index unter die mit dem kleineren, sodass die Wurzel
+// einer Menge immer ihr kleinstes Element ist.
+struct UnionFind {
+    vector<uint> parent;
+
+    // n einelementige Mengen erzeugen.
+    explicit UnionFind (uint n = 0) : parent(n) {
+        for (uint v = 0; v < n; v++) parent[v] = v;
+    }
+
+    // Wurzel der Menge von v liefern.
+    uint find (uint v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    // Mengen von u und v vereinigen.
+    // Resultatwert false, wenn beide schon in derselben Menge lagen.
+    bool unite (uint u, uint v) {
+        u = find(u);
+        v = find(v);
+        if (u == v) return false;
+        if (u < v) parent[v] = u;
+        else parent[u] = v;
+        return true;
+    }
+};
+
+/*
+ *  Zusammenhangskomponenten (Afforest)
+ */
+
+// Sperrfreie Vereinigung der Mengen von u und v im gemeinsamen Feld
+// comp (Shiloach-Vishkin-artiges Einhängen mit compare-and-swap):
+// Die Wurzel mit dem größeren Index wird unter den kleineren Index
+// gehängt. Schlägt das compare-and-swap fehl, weil ein anderer Thread
+// die Wurzel gerade umgehängt hat, wird mit den neuen Vertretern
+// erneut versucht.
+inline void link (uint u, uint v, vector<atomic<uint>>& comp) {
+    uint p1 = comp[u].load(memory_order_relaxed);
+    uint p2 = comp[v].load(memory_order_relaxed);
+    while (p1 != p2) {
+        uint high = max(p1, p2), low = min(p1, p2);
+        uint ph = comp[high].load(memory_order_relaxed);
+        if (ph == low) break;
+        if (ph == high && comp[high].compare_exchange_strong(ph, low)) break;
+        p1 = comp[comp[high].load(memory_order_relaxed)]
+                 .load(memory_order_relaxed);
+        p2 = comp[low].load(memory_order_relaxed);
+    }
+}
+
+// Alle Wege in comp parallel so verkürzen, dass jeder Eintrag direkt
+// auf die Wurzel seiner Menge zeigt.
+inline void compress (vector<atomic<uint>>& comp, ThreadPool& pool) {
+    pool.parallelFor(comp.size(), [&] (size_t v, uint) {
+        uint p = comp[v].load(memory_order_relaxed);
+        uint pp = comp[p].load(memory_order_relaxed);
+        while (p != pp) {
+            comp[v].store(pp, memory_order_relaxed);
+            p = pp;
+            pp = comp[p].load(memory_order_relaxed);
+        }
+    }, 1024);
+}
+
+// Zusammenhangskomponenten des ungerichteten Graphen g (jede Kante in
+// beiden Richtungen vorhanden) mit dem Afforest-Verfahren ermitteln.
+// labels[v] ist danach der kleinste Knotenindex der Komponente von v.
+// Resultatwert: Anzahl der Komponenten.
+// Ablauf:
+// 1. Für jeden Knoten werden nur seine ersten rounds Kanten parallel
+//    eingehängt; danach ist meist schon fast der ganze Graph in einer
+//    großen Komponente.
+// 2. Diese größte Komponente wird durch eine Stichprobe von Knoten
+//    bestimmt.
+// 3. Nur noch die Knoten außerhalb der größten Komponente hängen ihre
+//    restlichen Kanten ein. Kanten zwischen zwei Knoten der größten
+//    Komponente werden damit nie betrachtet; da jede Kante in beiden
+//    Richtungen vorhanden ist, geht dabei keine Verbindung verloren.
+// Im Vergleich zu scc entfallen Tiefensuche, Transposition und alle
+// Tabellen; jeder Schritt ist eine parallele Schleife über ein
+// flaches Feld.
+template <typename V>
+uint cc (const FrozenGraph<V>& g, vector<uint>& labels,
+         ThreadPool& pool = defaultPool(), uint rounds = 2) {
+    uint n = g.size();
+    vector<atomic<uint>> comp(n);
+    pool.parallelFor(n, [&] (size_t v, uint) {
+        comp[v].store(v, memory_order_relaxed);
+    }, 4096);
+
+    for (uint r = 0; r < rounds; r++) {
+        pool.parallelFor(n, [&] (size_t v, uint) {
+            uint e = g.off[v] + r;
+            if (e < g.off[v + 1]) link(v, g.tgt[e], comp);
+        }, 1024);
+        compress(comp, pool);
+    }
+
+    // Größte Komponente schätzen.
+    uint big = 0;
+    if (n > 0) {
+        mt19937 rng(n);
+        unordered_map<uint, uint> count;
+        uint most = 0;
+        for (uint i = 0; i < 1024; i++) {
+            uint c = comp[rng() % n].load(memory_order_relaxed);
+            if (++count[c] > most) {
+                most = count[c];
+                big = c;
+            }
+        }
+    }
+
+    pool.parallelFor(n, [&] (size_t v, uint) {
+        if (comp[v].load(memory_order_relaxed) == big) return;
+        for (uint e = g.off[v] + rounds; e < g.off[v + 1]; e++) {
+            link(v, g.tgt[e], comp);
+        }
+    }, 1024);
+    compress(comp, pool);
+
+    labels.resize(n);
+    uint count = 0;
+    for (uint v = 0; v < n; v++) {
+        labels[v] = comp[v].load(memory_order_relaxed);
+        if (labels[v] == v) count++;
+    }
+    return count;
+}
+
+/*
+ *  Starke Zusammenhangskomponenten auf eingefrorenen Graphen
+ */
+
+// Die starken Zusammenhangskomponenten des Graphen g mit dem
+// Algorithmus von Tarjan ermitteln und comp[v] auf die Nummer der
+// Komponente des Knotens v setzen.
+// Resultatwert: Anzahl der Komponenten.
+// Die Komponenten werden in der Reihenfolge ihres Abschlusses
+// nummeriert; das ist eine umgekehrte topologische Sortierung des
+// Komponentengraphen: Jede Kante zwischen zwei Komponenten führt von
+// einer höheren zu einer niedrigeren Nummer.
+// (Gleiche Komponenten wie scc, aber mit einer einzigen iterativen
+// Tiefensuche über flache Felder statt zweier rekursiver Tiefensuchen
+// und Transposition.)
+template <typename V>
+uint scc (const FrozenGraph<V>& g, vector<uint>& comp) {
+    uint n = g.size(), count = 0, time = 0;
+    vector<uint> det(n, NONE), low(n), stack, frames, pos;
+    vector<bool> on(n, false);
+    comp.assign(n, NONE);
+
+    for (uint r = 0; r < n; r++) {
+        if (det[r] != NONE) continue;
+        frames.push_back(r);
+        pos.push_back(g.off[r]);
+        det[r] = low[r] = time++;
+        stack.push_back(r);
+        on[r] = true;
+
+        while (!frames.empty()) {
+            uint v = frames.back();
+            uint& e = pos.back();
+            if (e < g.off[v + 1]) {
+                uint w = g.tgt[e++];
+                if (det[w] == NONE) {
+                    frames.push_back(w);
+                    pos.push_back(g.off[w]);
+                    det[w] = low[w] = time++;
+                    stack.push_back(w);
+                    on[w] = true;
+                } else if (on[w]) {
+                    low[v] = min(low[v], det[w]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            pos.pop_back();
+            if (low[v] == det[v]) {
+                uint w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on[w] = false;
+                    comp[w] = count;
+                } while (w != v);
+                count++;
+            }
+            if (!frames.empty()) {
+                uint p = frames.back();
+                low[p] = min(low[p], low[v]);
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <utility>	// pair
+#include <vector>
+
+#include "graph.h"
+#include "hugepage.h"
+
+// Ersatzwert für einen ungültigen Knotenindex (entspricht NIL bei Pred<V>).
+constexpr uint NONE = numeric_limits<uint>::max();
+
+/*
+ *  Eingefrorene Graphen
+ */
+
+// Nur noch lesbare Darstellung eines (gewichteten) Graphen im
+// CSR-Format (compressed sparse row).
+// Die Knoten werden auf die Indizes 0 bis size() - 1 abgebildet.
+// Die Nachfolger des Knotens mit Index i stehen in tgt zwischen den
+// Positionen off[i] (einschließlich) und off[i + 1] (ausschließlich),
+// die zugehörigen Kantengewichte an den gleichen Positionen in wt.
+// (Bei einem ungewichteten Graphen ist wt leer.)
+template <typename V>
+struct FrozenGraph {
+    // Knoten nach Index sowie Index nach Knoten.
+    vector<V> vs;
+    map<V, uint> idx;
+
+    // Kantenanfänge je Knoten (size() + 1 Einträge), Kantenziele und
+    // Kantengewichte (bei Bedarf mit großen Seiten, siehe hugePages).
+    BigArray<uint> off, tgt;
+    BigArray<double> wt;
+
+    // Anzahl der Knoten bzw. Kanten.
+    uint size () const { return vs.size(); }
+    uint edges () const { return tgt.size(); }
+
+    // Besitzt der Graph Kantengewichte?
+    bool weighted () const { return !wt.empty(); }
+
+    // Index des Knotens v liefern (NONE, wenn v nicht vorkommt).
+    uint index (V v) const {
+        auto it = idx.find(v);
+        return it == idx.end() ? NONE : it->second;
+    }
+
+    // Knoten mit Index i liefern.
+    V vertex (uint i) const { return vs[i]; }
+
+    // Gewicht der Kante an Position e liefern
+    // (1 bei einem ungewichteten Graphen).
+    double weight (uint e) const { return wt.empty() ? 1 : wt[e]; }
+
+    // Transponierten Graphen als neues, unabhängiges Objekt liefern.
+    // (Wie Graph<V>::transpose, aber mit Zählen der Eingangsgrade und
+    // anschließendem Verteilen der Kanten in O(n + m).)
+    FrozenGraph<V> transpose () const {
+        FrozenGraph<V> t;
+        t.vs = vs;
+        t.idx = idx;
+        t.off.assign(size() + 1, 0);
+        for (uint v : tgt) t.off[v + 1]++;
+        for (uint i = 0; i < size(); i++) t.off[i + 1] += t.off[i];
+
+        t.tgt.resize(edges());
+        if (weighted()) t.wt.resize(edges());
+        vector<uint> pos(t.off.begin(), t.off.end() - 1);
+        for (uint u = 0; u < size(); u++) {
+            for (uint e = off[u]; e < off[u + 1]; e++) {
+                uint x = pos[tgt[e]]++;
+                t.tgt[x] = u;
+                if (weighted()) t.wt[x] = wt[e];
+            }
+        }
+        return t;
+    }
+};
+
+// Hilfsfunktion für freeze: CSR-Darstellung aus der
+// Adjazenzlistendarstellung adj aufbauen.
+// Knoten, die nur als Nachfolger vorkommen, erhalten ebenfalls einen
+// Index (mit einer leeren Nachfolgerliste).
+template <typename V>
+void freezeAdj (const map<V, list<V>>& adj, FrozenGraph<V>& f) {
+    for (auto& p : adj) {
+        f.idx.insert({ p.first, 0 });
+        for (auto& v : p.second) f.idx.insert({ v, 0 });
+    }
+    for (auto& p : f.idx) {
+        p.second = f.vs.size();
+        f.vs.push_back(p.first);
+    }
+
+    f.off.assign(f.size() + 1, 0);
+    for (auto& p : adj) f.off[f.idx[p.first] + 1] = p.second.size();
+    for (uint i = 0; i < f.size(); i++) f.off[i + 1] += f.off[i];
+
+    f.tgt.resize(f.off[f.size()]);
+    for (auto& p : adj) {
+        uint e = f.off[f.idx[p.first]];
+        for (auto& v : p.second) f.tgt[e++] = f.idx[v];
+    }
+}
+
+// Ungewichteten Graphen g einfrieren.
+template <typename V>
+FrozenGraph<V> freeze (Graph<V>& g) {
+    FrozenGraph<V> f;
+    freezeAdj(g.adj, f);
+    return f;
+}
+
+// Gewichteten Graphen g einfrieren.
+template <typename V>
+FrozenGraph<V> freeze (WeightedGraph<V>& g) {
+    FrozenGraph<V> f;
+    freezeAdj(g.adj, f);
+    f.wt.resize(f.edges());
+    for (uint u = 0; u < f.size(); u++) {
+        for (uint e = f.off[u]; e < f.off[u + 1]; e++) {
+            f.wt[e] = g.weight(f.vs[u], f.vs[f.tgt[e]]);
+        }
+    }
+    return f;
+}
+
+/*
+ *  Wiederverwendbarer Arbeitsspeicher für Suchen
+ */
+
+// Arbeitsspeicher für Breitensuche und Dijkstra auf einem FrozenGraph,
+// der über viele Suchen hinweg wiederverwendet werden kann.
+// Statt dist und pred vor jeder Suche vollständig zurückzusetzen, wird
+// jeder Eintrag mit der Nummer der Suche (epoch) markiert, in der er
+// zuletzt geschrieben wurde; ältere Einträge gelten als "unendlich"
+// bzw. NIL. Eine Suche kostet damit nur so viel, wie sie Knoten
+// berührt.
+struct Workspace {
+    BigArray<double> dist;
+    BigArray<uint> pred, mark;
+    uint epoch = 0;
+
+    // Warteschlange der Breitensuche bzw. Halde von Dijkstra.
+    vector<uint> queue;
+    vector<pair<double, uint>> heap;
+
+    // Neue Suche auf einem Graphen mit n Knoten beginnen.
+    void reset (uint n) {
+        if (mark.size() != n || epoch == NONE - 1) {
+            dist.assign(n, numeric_limits<double>::infinity());
+            pred.assign(n, NONE);
+            mark.assign(n, 0);
+            epoch = 0;
+        }
+        epoch++;
+        queue.clear();
+        heap.clear();
+    }
+
+    // Wurde der Knoten mit Index v in der aktuellen Suche erreicht?
+    bool seen (uint v) const { return mark[v] == epoch; }
+
+    // Distanz bzw. Vorgänger des Knotens mit Index v in der aktuellen
+    // Suche liefern.
+    double distance (uint v) const {
+        return seen(v) ? dist[v] : numeric_limits<double>::infinity();
+    }
+    uint predecessor (uint v) const { return seen(v) ? pred[v] : NONE; }
+
+    // Einträge des Knotens v vorab in den Cache laden lassen (siehe
+    // prefetchDistance).
+    void prefetch (uint v) const {
+#ifdef __GNUC__
+        __builtin_prefetch(&mark[v]);
+        __builtin_prefetch(&dist[v]);
+#endif
+    }
+
+    // Knoten v mit Distanz d und Vorgänger u eintragen.
+    void set (uint v, double d, uint u) {
+        mark[v] = epoch;
+        dist[v] = d;
+        pred[v] = u;
+    }
+
+    // Weg vom Startknoten zum Knoten mit Index t in p speichern
+    // (leer, wenn t nicht erreicht wurde).
+    void path (uint t, vector<uint>& p) const {
+        p.clear();
+        if (t == NONE || !seen(t)) return;
+        for (uint v = t; v != NONE; v = pred[v]) p.push_back(v);
+        reverse(p.begin(), p.end());
+    }
+};
+
+// Vergleich für die Min-Halde von Dijkstra.
+struct HeapGreater {
+    bool operator() (const pair<double, uint>& a,
+                     const pair<double, uint>& b) const {
+        return a.first > b.first;
+    }
+};
+
+/*
+ *  Algorithmen auf eingefrorenen Graphen
+ */
+
+// Vorausladeabstand der Suchen: Beim Durchlaufen der Nachfolger eines
+// Knotens werden die Einträge (mark und dist) des Nachfolgers, der
+// prefetchDistance() Kanten weiter hinten steht, schon vorab angefordert.
+// Die zufälligen Zugriffe auf diese Felder sind bei Graphen, die nicht
+// mehr in den Cache passen, der größte Kostenfaktor; so überlappen sich
+// mehrere davon. 0 schaltet das Vorausladen ab. (Der beste Wert hängt
+// vom Rechner ab, siehe Algo_U3_bench prefetch.)
+inline atomic<uint>& prefetchDistance () {
+    static atomic<uint> distance(8);
+    return distance;
+}
+
+// Einträge der ersten pd Nachfolger des Knotens u vorab laden; danach
+// lädt die Schleife über die Kanten jeweils pd Kanten voraus.
+template <typename V>
+void prefetchFirst (const FrozenGraph<V>& g, uint u, const Workspace& ws,
+                    uint pd) {
+    uint end = min(g.off[u + 1], g.off[u] + pd);
+    for (uint e = g.off[u]; e < end; e++) ws.prefetch(g.tgt[e]);
+}
+
+// Breitensuche im Graphen g mit Startknoten s (Index) ausführen und das
+// Ergebnis in ws speichern.
+// ws.queue enthält danach alle erreichten Knoten in der Reihenfolge
+// ihrer Entdeckung, also nach aufsteigender Distanz.
+// Wenn ein Zielknoten t angegeben ist, wird die Suche abgebrochen,
+// sobald t erreicht ist.
+template <typename V>
+void bfs (const FrozenGraph<V>& g, uint s, Workspace& ws, uint t = NONE) {
+    ws.reset(g.size());
+    ws.set(s, 0, NONE);
+    ws.queue.push_back(s);
+    if (s == t) return;
+
+    uint pd = prefetchDistance().load(memory_order_relaxed);
+    for (size_t i = 0; i < ws.queue.size(); i++) {
+        uint u = ws.queue[i], end = g.off[u + 1];
+        if (pd) prefetchFirst(g, u, ws, pd);
+        for (uint e = g.off[u]; e < end; e++) {
+            if (pd && e + pd < end) ws.prefetch(g.tgt[e + pd]);
+            uint v = g.tgt[e];
+            if (!ws.seen(v)) {
+                ws.set(v, ws.dist[u] + 1, u);
+                ws.queue.push_back(v);
+                if (v == t) return;
+            }
+        }
+    }
+}
+
+// Kürzeste Wege vom Startknoten s (Index) im Graphen g mit dem
+// Algorithmus von Dijkstra ermitteln und das Ergebnis in ws speichern.
+// Es werden nur Kanten e (Positionen im CSR-Format) verwendet, für die
+// use(e) true liefert; damit lassen sich Kanten und Knoten ausblenden,
+// ohne den Graphen zu kopieren.
+// Wenn ein Zielknoten t angegeben ist, wird die Suche abgebrochen,
+// sobald die Distanz von t endgültig feststeht.
+// Die Kanten des Graphen dürfen keine negativen Gewichte besitzen.
+// ws.queue enthält danach (wie bei der Breitensuche) alle erledigten
+// Knoten nach aufsteigender Distanz.
+// (Binäre Halde mit verzögertem Löschen: Veraltete Einträge bleiben
+// in der Halde und werden beim Entnehmen übersprungen.)
+template <typename V, typename F>
+void dijkstraIf (const FrozenGraph<V>& g, uint s, Workspace& ws, uint t,
+                 F use) {
+    ws.reset(g.size());
+    ws.set(s, 0, NONE);
+    ws.heap.push_back({ 0, s });
+    uint pd = prefetchDistance().load(memory_order_relaxed);
+
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), HeapGreater());
+        double d = ws.heap.back().first;
+        uint u = ws.heap.back().second;
+        ws.heap.pop_back();
+        if (d > ws.dist[u]) continue;
+        ws.queue.push_back(u);
+        if (u == t) return;
+
+        uint end = g.off[u + 1];
+        if (pd) prefetchFirst(g, u, ws, pd);
+        for (uint e = g.off[u]; e < end; e++) {
+            if (pd && e + pd < end) ws.prefetch(g.tgt[e + pd]);
+            if (!use(e)) continue;
+            uint v = g.tgt[e];
+            double dv = d + g.weight(e);
+            if (dv < ws.distance(v)) {
+                ws.set(v, dv, u);
+                ws.heap.push_back({ dv, v });
+                push_heap(ws.heap.begin(), ws.heap.end(), HeapGreater());
+            }
+        }
+    }
+}
+
+// Kürzeste Wege vom Startknoten s (Index) im Graphen g mit dem
+// Algorithmus von Dijkstra ermitteln und das Ergebnis in ws speichern
+// (siehe dijkstraIf, hier mit allen Kanten).
+template <typename V>
+void dijkstra (const FrozenGraph<V>& g, uint s, Workspace& ws,
+               uint t = NONE) {
+    dijkstraIf(g, s, ws, t, [] (uint) { return true; });
+}
+
+// Ist der Knoten t (Index) im Graphen g vom Knoten s (Index) aus
+// erreichbar?
+template <typename V>
+bool reachable (const FrozenGraph<V>& g, uint s, uint t, Workspace& ws) {
+    bfs(g, s, ws, t);
+    return ws.seen(t);
+}
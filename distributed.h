@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "partition.h"
+#include "server.h"
+
+/*
+ *  Nachrichtenaustausch zwischen den Teilen eines zerlegten Graphen
+ */
+
+// Austauschschicht für k Teilnehmer (Prozesse oder Threads) mit den
+// Nummern 0 bis size() - 1.
+// Die Algorithmen arbeiten in Supersteps: exchange wird von allen
+// Teilnehmern gemeinsam aufgerufen, schickt out[p] an den Teilnehmer p
+// und liefert in in[p] die Nachricht von p (jeweils ein ganzer Stapel
+// von Aktualisierungen, möglicherweise leer).
+struct Transport {
+    virtual ~Transport () {}
+    virtual uint rank () const = 0;
+    virtual uint size () const = 0;
+    virtual bool exchange (vector<vector<char>>& out,
+                           vector<vector<char>>& in) = 0;
+};
+
+// Austausch über gemeinsamen Speicher zwischen k Threads eines
+// Prozesses: box[i * k + j] ist der Briefkasten von i an j. Ein
+// Superstep legt alle Nachrichten ab, wartet an einer Barriere auf alle
+// anderen und holt dann die eigenen ab; eine zweite Barriere verhindert,
+// dass ein schneller Teilnehmer die Briefkästen schon wieder füllt.
+struct SharedHub {
+    uint k;
+    vector<vector<char>> box;
+    mutex lock;
+    condition_variable cv;
+    uint waiting = 0;
+    uint64_t generation = 0;
+
+    explicit SharedHub (uint k) : k(k), box(size_t(k) * k) {}
+
+    void barrier () {
+        unique_lock<mutex> guard(lock);
+        uint64_t gen = generation;
+        if (++waiting == k) {
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+        } else {
+            cv.wait(guard, [&] { return generation != gen; });
+        }
+    }
+};
+
+struct SharedTransport : Transport {
+    SharedHub& hub;
+    uint r;
+
+    SharedTransport (SharedHub& hub, uint r) : hub(hub), r(r) {}
+
+    uint rank () const override { return r; }
+    uint size () const override { return hub.k; }
+
+    bool exchange (vector<vector<char>>& out,
+                   vector<vector<char>>& in) override {
+        uint k = hub.k;
+        for (uint p = 0; p < k; p++) hub.box[size_t(r) * k + p].swap(out[p]);
+        hub.barrier();
+        in.resize(k);
+        for (uint p = 0; p < k; p++) {
+            in[p].clear();
+            in[p].swap(hub.box[size_t(p) * k + r]);
+        }
+        hub.barrier();
+        for (auto& o : out) o.clear();
+        return true;
+    }
+};
+
+// Paarweise verbundene Unix-Domain-Sockets für k Prozesse auf demselben
+// Rechner anlegen (vor fork aufzurufen): fds[i][j] ist das Ende der
+// Verbindung von i zu j im Prozess i (fds[i][i] ist -1). Jeder Prozess
+// schließt nach fork die Zeilen der anderen (closeOthers).
+inline bool socketMesh (uint k, vector<vector<int>>& fds) {
+    fds.assign(k, vector<int>(k, -1));
+    for (uint i = 0; i < k; i++) {
+        for (uint j = i + 1; j < k; j++) {
+            int sv[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) return false;
+            fds[i][j] = sv[0];
+            fds[j][i] = sv[1];
+        }
+    }
+    return true;
+}
+
+inline void closeOthers (uint r, vector<vector<int>>& fds) {
+    for (uint i = 0; i < fds.size(); i++) {
+        if (i == r) continue;
+        for (int& fd : fds[i]) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+    }
+}
+
+// Austausch über Sockets (fds wie eine Zeile von socketMesh).
+// Jede Nachricht wird mit ihrer Länge (64 Bit) vorweg verschickt. Ein
+// Hilfsthread schreibt die Nachrichten an alle Partner in aufsteigender
+// Reihenfolge, während der aufrufende Thread in derselben Reihenfolge
+// liest; so blockieren volle Socketpuffer nie beide Seiten gleichzeitig.
+struct SocketTransport : Transport {
+    uint r;
+    vector<int> fds;
+
+    SocketTransport (uint r, const vector<int>& fds) : r(r), fds(fds) {}
+    ~SocketTransport () {
+        for (int fd : fds) if (fd >= 0) close(fd);
+    }
+
+    uint rank () const override { return r; }
+    uint size () const override { return fds.size(); }
+
+    bool exchange (vector<vector<char>>& out,
+                   vector<vector<char>>& in) override {
+        uint k = size();
+        in.resize(k);
+        bool sent = true;
+        thread writer([&] {
+            for (uint p = 0; p < k; p++) {
+                if (p == r) continue;
+                uint64_t len = out[p].size();
+                sent = sent && writeFull(fds[p], &len, sizeof(len))
+                       && writeFull(fds[p], out[p].data(), len);
+            }
+        });
+        bool ok = true;
+        for (uint p = 0; p < k; p++) {
+            if (p == r) continue;
+            uint64_t len = 0;
+            ok = ok && readFull(fds[p], &len, sizeof(len));
+            in[p].resize(ok ? len : 0);
+            ok = ok && readFull(fds[p], in[p].data(), len);
+        }
+        writer.join();
+        in[r].swap(out[r]);
+        for (auto& o : out) o.clear();
+        return ok && sent;
+    }
+};
+
+// Wert x an alle Teilnehmer verteilen und die Werte aller Teilnehmer in
+// xs sammeln (xs[p] ist der Wert von p).
+template <typename T>
+bool allGather (Transport& t, T x, vector<T>& xs) {
+    vector<vector<char>> out(t.size()), in;
+    for (auto& o : out) o.assign(reinterpret_cast<char*>(&x),
+                                 reinterpret_cast<char*>(&x) + sizeof(T));
+    if (!t.exchange(out, in)) return false;
+    xs.resize(t.size());
+    for (uint p = 0; p < t.size(); p++) {
+        if (in[p].size() != sizeof(T)) return false;
+        memcpy(&xs[p], in[p].data(), sizeof(T));
+    }
+    return true;
+}
+
+/*
+ *  Verteilte Breitensuche und Delta-Stepping
+ */
+
+// Aktualisierung eines fremden Knotens v (globaler Index): neue
+// Distanz d über den Vorgänger u (globaler Index).
+struct Update {
+    uint32_t v, u;
+    double d;
+};
+
+// Ergebnis eines Teils: Distanz und Vorgänger (globaler Index oder
+// NONE) jedes eigenen Knotens.
+struct PartResult {
+    vector<double> dist;
+    vector<uint> pred;
+};
+
+// Zustand eines Teilnehmers während einer verteilten Suche.
+// local bildet die globalen Indizes der eigenen Knoten auf lokale ab,
+// out sammelt je Zielteil die Aktualisierungen des laufenden
+// Supersteps; best[g] ist die kleinste in diesem Superstep schon
+// verschickte Distanz zum Geisterknoten g, sodass je Superstep und
+// Geisterknoten höchstens eine (die beste) Aktualisierung entsteht.
+struct PartSearch {
+    const GraphPart& part;
+    Transport& t;
+    PartResult& res;
+    unordered_map<uint, uint> local;
+    vector<vector<char>> out, in;
+    vector<double> best;
+    vector<uint> slot, sent;
+
+    PartSearch (const GraphPart& part, Transport& t, PartResult& res)
+            : part(part), t(t), res(res), out(t.size()),
+              best(part.ghosts()), slot(part.ghosts(), NONE) {
+        for (uint l = 0; l < part.owned; l++) local[part.global[l]] = l;
+        res.dist.assign(part.owned, numeric_limits<double>::infinity());
+        res.pred.assign(part.owned, NONE);
+    }
+
+    // Distanz d für den Geisterknoten x (lokaler Index) über den eigenen
+    // Knoten u (lokaler Index) vormerken.
+    void remote (uint x, double d, uint u) {
+        uint g = x - part.owned;
+        Update m = { part.global[x], part.global[u], d };
+        vector<char>& o = out[part.owner[g]];
+        if (slot[g] == NONE) {
+            slot[g] = o.size();
+            best[g] = d;
+            sent.push_back(g);
+            o.insert(o.end(), reinterpret_cast<char*>(&m),
+                     reinterpret_cast<char*>(&m) + sizeof(m));
+        } else if (d < best[g]) {
+            best[g] = d;
+            memcpy(o.data() + slot[g], &m, sizeof(m));
+        }
+    }
+
+    // Vorgemerkte Aktualisierungen verschicken und die empfangenen mit
+    // f(lokaler Index, Distanz, Vorgänger) verarbeiten.
+    template <typename F>
+    bool exchange (F f) {
+        for (uint g : sent) slot[g] = NONE;
+        sent.clear();
+        if (!t.exchange(out, in)) return false;
+        for (auto& buf : in) {
+            for (size_t x = 0; x + sizeof(Update) <= buf.size();
+                 x += sizeof(Update)) {
+                Update m;
+                memcpy(&m, buf.data() + x, sizeof(m));
+                auto it = local.find(m.v);
+                if (it != local.end()) f(it->second, m.d, m.u);
+            }
+        }
+        return true;
+    }
+
+    // Summe von x über alle Teilnehmer.
+    bool sum (uint64_t x, uint64_t& s) {
+        vector<uint64_t> xs;
+        if (!allGather(t, x, xs)) return false;
+        s = 0;
+        for (uint64_t y : xs) s += y;
+        return true;
+    }
+};
+
+// Verteilte Breitensuche vom Knoten s (globaler Index) aus. Alle
+// Teilnehmer rufen distBfs gemeinsam mit ihrem Teil part auf; danach
+// enthält res Kantenzahl und Vorgänger der eigenen Knoten.
+// Je Ebene werden die eigenen Knoten der Front lokal expandiert; Kanten
+// zu Geisterknoten werden je Zielteil in einer Nachricht gesammelt und
+// in einem Superstep verschickt. Jeder Geisterknoten wird nur einmal
+// gemeldet, weil die erste Meldung bereits die kleinste Ebene hat.
+// Resultatwert: Anzahl der Ebenen (0 bei einem Übertragungsfehler).
+inline uint distBfs (const GraphPart& part, uint s, Transport& t,
+                     PartResult& res) {
+    PartSearch ps(part, t, res);
+    vector<bool> reported(part.ghosts(), false);
+    vector<uint> front, next;
+    auto it = ps.local.find(s);
+    if (it != ps.local.end()) {
+        res.dist[it->second] = 0;
+        front.push_back(it->second);
+    }
+
+    for (uint level = 0; ; level++) {
+        next.clear();
+        for (uint u : front) {
+            for (uint e = part.off[u]; e < part.off[u + 1]; e++) {
+                uint v = part.tgt[e];
+                if (v >= part.owned) {
+                    if (!reported[v - part.owned]) {
+                        reported[v - part.owned] = true;
+                        ps.remote(v, level + 1, u);
+                    }
+                } else if (res.dist[v] == numeric_limits<double>::infinity()) {
+                    res.dist[v] = level + 1;
+                    res.pred[v] = part.global[u];
+                    next.push_back(v);
+                }
+            }
+        }
+        bool ok = ps.exchange([&] (uint v, double d, uint u) {
+            if (res.dist[v] != numeric_limits<double>::infinity()) return;
+            res.dist[v] = d;
+            res.pred[v] = u;
+            next.push_back(v);
+        });
+        uint64_t active;
+        if (!ok || !ps.sum(next.size(), active)) return 0;
+        if (active == 0) return level + 1;
+        front.swap(next);
+    }
+}
+
+// Verteiltes Delta-Stepping vom Knoten s (globaler Index) aus (keine
+// negativen Kantengewichte). Alle Teilnehmer rufen deltaStepping
+// gemeinsam auf; danach enthält res Distanz und Vorgänger der eigenen
+// Knoten.
+// Die Knoten liegen in Eimern der Breite delta (Eimer b enthält die
+// Distanzen in [b * delta, (b + 1) * delta)). Alle Teilnehmer bearbeiten
+// gemeinsam den kleinsten nichtleeren Eimer: In jedem Superstep werden
+// die Kanten der zuletzt verbesserten Knoten dieses Eimers relaxiert,
+// lokale Ziele sofort, fremde gesammelt je Zielteil. Ist der Eimer
+// überall leer, folgt der nächste. (Im Unterschied zum ursprünglichen
+// Verfahren werden leichte und schwere Kanten nicht getrennt, sondern
+// immer alle Kanten relaxiert.)
+// Resultatwert: Anzahl der Supersteps (0 bei einem Übertragungsfehler).
+inline uint deltaStepping (const GraphPart& part, uint s, double delta,
+                           Transport& t, PartResult& res) {
+    PartSearch ps(part, t, res);
+    map<uint64_t, vector<uint>> buckets;
+    auto bucket = [&] (double d) { return uint64_t(floor(d / delta)); };
+    auto improve = [&] (uint v, double d, uint u) {
+        if (!(d < res.dist[v])) return;
+        res.dist[v] = d;
+        res.pred[v] = u;
+        buckets[bucket(d)].push_back(v);
+    };
+    auto it = ps.local.find(s);
+    if (it != ps.local.end()) improve(it->second, 0, NONE);
+
+    uint steps = 0;
+    vector<uint> active;
+    for (;;) {
+        // Kleinsten Eimer mit gültigen Einträgen über alle Teilnehmer.
+        uint64_t mine = numeric_limits<uint64_t>::max();
+        while (!buckets.empty()) {
+            auto b = buckets.begin();
+            auto& vs = b->second;
+            vs.erase(remove_if(vs.begin(), vs.end(), [&] (uint v) {
+                return bucket(res.dist[v]) != b->first;
+            }), vs.end());
+            if (!vs.empty()) {
+                mine = b->first;
+                break;
+            }
+            buckets.erase(b);
+        }
+        vector<uint64_t> all;
+        if (!allGather(t, mine, all)) return 0;
+        uint64_t cur = *min_element(all.begin(), all.end());
+        if (cur == numeric_limits<uint64_t>::max()) return steps;
+
+        for (;;) {
+            active.clear();
+            auto b = buckets.find(cur);
+            if (b != buckets.end()) {
+                active.swap(b->second);
+                buckets.erase(b);
+            }
+            sort(active.begin(), active.end());
+            active.erase(unique(active.begin(), active.end()), active.end());
+            for (uint u : active) {
+                if (bucket(res.dist[u]) != cur) continue;
+                for (uint e = part.off[u]; e < part.off[u + 1]; e++) {
+                    uint v = part.tgt[e];
+                    double d = res.dist[u] + part.wt[e];
+                    if (v >= part.owned) ps.remote(v, d, u);
+                    else improve(v, d, part.global[u]);
+                }
+            }
+            steps++;
+            if (!ps.exchange(improve)) return 0;
+            b = buckets.find(cur);
+            uint64_t left;
+            if (!ps.sum(b == buckets.end() ? 0 : b->second.size(), left)) {
+                return 0;
+            }
+            if (left == 0) break;
+        }
+    }
+}
+
+// Ergebnisse aller Teilnehmer beim Teilnehmer 0 einsammeln und dort in
+// res (BFS<V> oder SP<V>) eintragen; vs bildet die globalen Indizes auf
+// die Knoten ab (vs des ursprünglichen FrozenGraph, nur bei Teilnehmer
+// 0 nötig).
+// Resultatwert false bei einem Übertragungsfehler.
+template <typename V, typename R>
+bool gather (const GraphPart& part, const PartResult& pr, Transport& t,
+             const vector<V>& vs, R& res) {
+    vector<vector<char>> out(t.size()), in;
+    for (uint l = 0; l < part.owned; l++) {
+        Update m = { part.global[l], pr.pred[l], pr.dist[l] };
+        out[0].insert(out[0].end(), reinterpret_cast<char*>(&m),
+                      reinterpret_cast<char*>(&m) + sizeof(m));
+    }
+    if (!t.exchange(out, in)) return false;
+    if (t.rank() != 0) return true;
+    for (auto& buf : in) {
+        for (size_t x = 0; x + sizeof(Update) <= buf.size(); x += sizeof(Update)) {
+            Update m;
+            memcpy(&m, buf.data() + x, sizeof(m));
+            V v = vs[m.v];
+            res.pred[v] = m.u == NONE ? res.NIL : vs[m.u];
+            if (m.d == numeric_limits<double>::infinity()) res.dist[v] = res.INF;
+            else res.dist[v] = m.d;
+        }
+    }
+    return true;
+}
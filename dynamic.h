@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>	// pair
+#include <vector>
+
+#include "csr.h"
+
+/*
+ *  Veränderlicher Graph
+ */
+
+// Gerichteter (gewichteter) Graph, der stapelweises Einfügen und
+// Löschen von Kanten sowie Ändern von Kantengewichten unterstützt und
+// jederzeit als FrozenGraph eingefroren werden kann.
+// Die Nachfolger jedes Knotens liegen als Block in einem gemeinsamen
+// Feld (tgt bzw. wt) mit Reserve am Ende (cap[v] >= len[v]). Solange
+// die Reserve reicht, kostet ein Einfügen nur das Schreiben der Kante;
+// läuft ein Block über, wird er einmal mit doppelter Kapazität an das
+// Ende des Feldes verlegt (amortisiert O(1) je Kante). Verlassene
+// Blöcke werden beim Kompaktieren freigegeben, sobald sie mehr als die
+// Hälfte des Feldes belegen.
+// Jede Kante (u, v) kommt höchstens einmal vor; erneutes Einfügen
+// ändert nur ihr Gewicht (wie die Tabelle wt von WeightedGraph).
+// version wird bei jeder Änderung erhöht, sodass zwischengespeicherte
+// Ergebnisse erkennen können, dass sie veraltet sind.
+template <typename V>
+struct DynamicGraph {
+    // Kante (u, v) mit Gewicht w für die Stapeloperationen.
+    struct Edge {
+        V u, v;
+        double w;
+    };
+
+    vector<V> vs;
+    map<V, uint> idx;
+    vector<uint> start, len, cap;
+    vector<uint> tgt;
+    vector<double> wt;
+    bool weighted;
+    size_t garbage = 0;
+    uint64_t version = 0;
+
+    // Leeren Graphen erzeugen.
+    explicit DynamicGraph (bool weighted = true) : weighted(weighted) {}
+
+    // Graphen mit dem Inhalt von g erzeugen.
+    explicit DynamicGraph (Graph<V>& g) : weighted(false) {
+        copy(freeze(g));
+    }
+    explicit DynamicGraph (WeightedGraph<V>& g) : weighted(true) {
+        copy(freeze(g));
+    }
+
+    // Anzahl der Knoten bzw. Kanten.
+    uint size () const { return vs.size(); }
+    size_t edges () const {
+        size_t m = 0;
+        for (uint l : len) m += l;
+        return m;
+    }
+
+    // Index des Knotens v liefern und v dabei ggf. neu anlegen.
+    uint vertex (V v) {
+        auto it = idx.find(v);
+        if (it != idx.end()) return it->second;
+        uint i = vs.size();
+        idx[v] = i;
+        vs.push_back(v);
+        start.push_back(tgt.size());
+        len.push_back(0);
+        cap.push_back(0);
+        return i;
+    }
+
+    // Index des Knotens v liefern (NONE, wenn v nicht vorkommt).
+    uint index (V v) const {
+        auto it = idx.find(v);
+        return it == idx.end() ? NONE : it->second;
+    }
+
+    // Gewicht der Kante (u, v) liefern
+    // (unendlich, wenn es die Kante nicht gibt).
+    double weight (V u, V v) const {
+        uint a = index(u), b = index(v);
+        if (a == NONE || b == NONE) return numeric_limits<double>::infinity();
+        for (uint e = start[a]; e < start[a] + len[a]; e++) {
+            if (tgt[e] == b) return weighted ? wt[e] : 1;
+        }
+        return numeric_limits<double>::infinity();
+    }
+
+    // Alle Kanten es einfügen (bzw. ihr Gewicht ändern, falls es sie
+    // schon gibt). Fehlende Knoten werden angelegt.
+    // Die Kanten werden nach Startknoten gruppiert, sodass jeder Block
+    // höchstens einmal durchsucht und verlegt wird.
+    void insertEdges (const vector<Edge>& es) {
+        vector<pair<uint, pair<uint, double>>> batch;
+        batch.reserve(es.size());
+        for (auto& e : es) {
+            uint u = vertex(e.u);
+            batch.push_back({ u, { vertex(e.v), e.w } });
+        }
+        stable_sort(batch.begin(), batch.end(),
+                    [] (const pair<uint, pair<uint, double>>& a,
+                        const pair<uint, pair<uint, double>>& b) {
+                        return a.first < b.first;
+                    });
+
+        map<uint, double> add;
+        for (size_t i = 0; i < batch.size(); ) {
+            uint u = batch[i].first;
+            add.clear();
+            for (; i < batch.size() && batch[i].first == u; i++) {
+                add[batch[i].second.first] = batch[i].second.second;
+            }
+            // Vorhandene Kanten nur umgewichten.
+            for (uint e = start[u]; e < start[u] + len[u]; e++) {
+                auto it = add.find(tgt[e]);
+                if (it == add.end()) continue;
+                if (weighted) wt[e] = it->second;
+                add.erase(it);
+            }
+            reserve(u, len[u] + add.size());
+            for (auto& p : add) {
+                uint e = start[u] + len[u]++;
+                tgt[e] = p.first;
+                if (weighted) wt[e] = p.second;
+            }
+        }
+        version++;
+    }
+
+    // Alle Kanten es = (u, v) löschen (nicht vorhandene werden
+    // ignoriert). Die Lücken werden durch die letzten Kanten des
+    // jeweiligen Blocks gefüllt.
+    void removeEdges (const vector<pair<V, V>>& es) {
+        vector<pair<uint, uint>> batch;
+        for (auto& e : es) {
+            uint u = index(e.first), v = index(e.second);
+            if (u != NONE && v != NONE) batch.push_back({ u, v });
+        }
+        sort(batch.begin(), batch.end());
+
+        for (size_t i = 0; i < batch.size(); ) {
+            uint u = batch[i].first;
+            size_t j = i;
+            while (j < batch.size() && batch[j].first == u) j++;
+            auto b = batch.begin() + i, end = batch.begin() + j;
+            uint e = start[u];
+            while (e < start[u] + len[u]) {
+                if (binary_search(b, end, make_pair(u, tgt[e]))) {
+                    uint last = start[u] + --len[u];
+                    tgt[e] = tgt[last];
+                    if (weighted) wt[e] = wt[last];
+                } else {
+                    e++;
+                }
+            }
+            i = j;
+        }
+        version++;
+    }
+
+    // Gewichte der vorhandenen Kanten es ändern (nicht vorhandene
+    // Kanten werden ignoriert).
+    void updateWeights (const vector<Edge>& es) {
+        for (auto& x : es) {
+            uint u = index(x.u), v = index(x.v);
+            if (u == NONE || v == NONE || !weighted) continue;
+            for (uint e = start[u]; e < start[u] + len[u]; e++) {
+                if (tgt[e] == v) wt[e] = x.w;
+            }
+        }
+        version++;
+    }
+
+    // Nur lesbare CSR-Darstellung des aktuellen Zustands liefern.
+    // Die Knotenindizes stimmen mit denen dieses Graphen überein.
+    FrozenGraph<V> snapshot () const {
+        FrozenGraph<V> f;
+        f.vs = vs;
+        f.idx = idx;
+        f.off.assign(size() + 1, 0);
+        for (uint u = 0; u < size(); u++) f.off[u + 1] = f.off[u] + len[u];
+        f.tgt.resize(f.off[size()]);
+        if (weighted) f.wt.resize(f.off[size()]);
+        for (uint u = 0; u < size(); u++) {
+            std::copy(tgt.begin() + start[u], tgt.begin() + start[u] + len[u],
+                      f.tgt.begin() + f.off[u]);
+            if (weighted) {
+                std::copy(wt.begin() + start[u],
+                          wt.begin() + start[u] + len[u],
+                          f.wt.begin() + f.off[u]);
+            }
+        }
+        return f;
+    }
+
+    // Block des Knotens u auf mindestens need Plätze vergrößern.
+    void reserve (uint u, size_t need) {
+        if (need <= cap[u]) return;
+        uint c = max<size_t>(max<size_t>(2 * cap[u], need), 4);
+        if (garbage + cap[u] > tgt.size() / 2 && garbage > 0) compact();
+        uint s = tgt.size();
+        tgt.resize(s + c);
+        if (weighted) wt.resize(s + c);
+        std::copy(tgt.begin() + start[u], tgt.begin() + start[u] + len[u],
+                  tgt.begin() + s);
+        if (weighted) {
+            std::copy(wt.begin() + start[u], wt.begin() + start[u] + len[u],
+                      wt.begin() + s);
+        }
+        garbage += cap[u];
+        start[u] = s;
+        cap[u] = c;
+    }
+
+    // Alle Blöcke lückenlos (mit ihrer Reserve) neu anordnen.
+    void compact () {
+        vector<uint> t;
+        vector<double> w;
+        t.reserve(tgt.size() - garbage);
+        for (uint u = 0; u < size(); u++) {
+            uint s = t.size();
+            t.insert(t.end(), tgt.begin() + start[u],
+                     tgt.begin() + start[u] + cap[u]);
+            if (weighted) {
+                w.insert(w.end(), wt.begin() + start[u],
+                         wt.begin() + start[u] + cap[u]);
+            }
+            start[u] = s;
+        }
+        tgt.swap(t);
+        wt.swap(w);
+        garbage = 0;
+    }
+
+    // Inhalt des eingefrorenen Graphen f übernehmen (mit etwas Reserve
+    // je Knoten).
+    // Mehrfach vorkommende Nachfolger (in Graph<V> möglich) ergeben nur
+    // eine Kante; wie beim erneuten Einfügen gilt das letzte Gewicht.
+    // (from[v] ist der letzte Knoten mit dem Nachfolger v, at[v] die
+    // Stelle dieser Kante.)
+    void copy (const FrozenGraph<V>& f) {
+        for (uint u = 0; u < f.size(); u++) vertex(f.vs[u]);
+        vector<uint> from(f.size(), NONE), at(f.size());
+        for (uint u = 0; u < f.size(); u++) {
+            reserve(u, f.off[u + 1] - f.off[u] + 1);
+            for (uint e = f.off[u]; e < f.off[u + 1]; e++) {
+                uint v = f.tgt[e];
+                if (from[v] != u) {
+                    from[v] = u;
+                    at[v] = start[u] + len[u]++;
+                    tgt[at[v]] = v;
+                }
+                if (weighted) wt[at[v]] = f.weight(e);
+            }
+        }
+    }
+};
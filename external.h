@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "components.h"
+#include "csr.h"
+
+/*
+ *  Kantendateien für Graphen, die nicht in den Hauptspeicher passen
+ */
+
+// Binäre Kantendatei: Kopf aus EDGE_MAGIC, Knotenzahl n und Kantenzahl m
+// (je 64 Bit), danach m Kanten als Paare (u, v) von 32-Bit-Knotenindizes
+// 0 bis n - 1 in beliebiger Reihenfolge.
+constexpr uint64_t EDGE_MAGIC = 0x3145474445;	// "EDGE1"
+
+// Kantendatei schreiben, ohne den Graphen im Speicher zu halten.
+// Die Kanten werden gepuffert angehängt; close trägt n (größter
+// Knotenindex + 1) und m in den Kopf ein.
+struct EdgeWriter {
+    FILE* f = nullptr;
+    uint64_t n = 0, m = 0;
+    vector<uint32_t> buf;
+
+    ~EdgeWriter () { if (f) fclose(f); }
+
+    // Datei path anlegen. Resultatwert false bei einem Fehler.
+    bool open (const char* path) {
+        f = fopen(path, "wb");
+        uint64_t head[3] = { EDGE_MAGIC, 0, 0 };
+        return f && fwrite(head, sizeof(head), 1, f) == 1;
+    }
+
+    // Kante (u, v) anhängen.
+    bool add (uint32_t u, uint32_t v) {
+        buf.push_back(u);
+        buf.push_back(v);
+        n = max<uint64_t>(n, max(u, v) + uint64_t(1));
+        m++;
+        return buf.size() < (1 << 20) || flush();
+    }
+
+    bool flush () {
+        bool ok = fwrite(buf.data(), sizeof(uint32_t), buf.size(), f)
+                  == buf.size();
+        buf.clear();
+        return ok;
+    }
+
+    // Kopf vervollständigen und Datei schließen.
+    bool close () {
+        uint64_t head[3] = { EDGE_MAGIC, n, m };
+        bool ok = flush() && fseek(f, 0, SEEK_SET) == 0
+                  && fwrite(head, sizeof(head), 1, f) == 1;
+        ok = fclose(f) == 0 && ok;
+        f = nullptr;
+        return ok;
+    }
+};
+
+// Alle Kanten des Graphen g (als Knotenindizes) in die Kantendatei path
+// schreiben.
+template <typename V>
+bool writeEdges (const FrozenGraph<V>& g, const char* path) {
+    EdgeWriter w;
+    if (!w.open(path)) return false;
+    for (uint u = 0; u < g.size(); u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            if (!w.add(u, g.tgt[e])) return false;
+        }
+    }
+    w.n = max<uint64_t>(w.n, g.size());
+    return w.close();
+}
+
+// Sequenzieller Lesezugriff auf eine Kantendatei.
+// scan liest die Datei in Stücken von chunk Kanten mit pread von vorne
+// nach hinten; während ein Stück verarbeitet wird, liest ein
+// Hilfsthread bereits das nächste (Vorauslesen mit zwei Puffern).
+// Zusätzlich wird dem Betriebssystem der sequenzielle Zugriff
+// angekündigt. So bleibt der Speicherbedarf unabhängig von der Größe der
+// Datei, und jeder Durchlauf erzeugt nur große, aufeinanderfolgende
+// Lesezugriffe statt verstreuter Seitenfehler.
+struct EdgeStream {
+    int fd = -1;
+    uint64_t n = 0, m = 0;
+    size_t chunk;
+    vector<uint32_t> buf[2];
+
+    explicit EdgeStream (size_t chunk = 1 << 20) : chunk(max<size_t>(chunk, 1)) {}
+    ~EdgeStream () { if (fd >= 0) ::close(fd); }
+
+    // Kantendatei path öffnen.
+    // Resultatwert false, wenn die Datei fehlt oder ungültig ist.
+    bool open (const char* path) {
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        uint64_t head[3];
+        struct stat st;
+        if (pread(fd, head, sizeof(head), 0) != ssize_t(sizeof(head))
+                || head[0] != EDGE_MAGIC || fstat(fd, &st) < 0
+                || uint64_t(st.st_size) != sizeof(head) + head[2] * 8) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        n = head[1];
+        m = head[2];
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    // Kanten i bis i + k - 1 in den Puffer b lesen.
+    bool readChunk (uint64_t i, size_t k, vector<uint32_t>& b) const {
+        b.resize(2 * k);
+        char* p = reinterpret_cast<char*>(b.data());
+        size_t len = k * 8;
+        off_t pos = 24 + i * 8;
+        while (len > 0) {
+            ssize_t r = pread(fd, p, len, pos);
+            if (r <= 0) return false;
+            p += r;
+            pos += r;
+            len -= r;
+        }
+        return true;
+    }
+
+    // Alle Kanten einmal durchlaufen und für jede f(u, v) aufrufen.
+    // Resultatwert false bei einem Lesefehler.
+    template <typename F>
+    bool scan (F f) {
+        if (m == 0) return true;
+        size_t k = min<uint64_t>(chunk, m);
+        bool ok = readChunk(0, k, buf[0]);
+        for (uint64_t i = 0; ok && i < m; ) {
+            uint64_t j = i + k;
+            size_t next = min<uint64_t>(chunk, m - j);
+            future<bool> ahead;
+            if (next > 0) {
+                ahead = async(launch::async, [this, j, next] {
+                    return readChunk(j, next, buf[1]);
+                });
+            }
+            const uint32_t* e = buf[0].data();
+            for (size_t x = 0; x < k; x++) f(e[2 * x], e[2 * x + 1]);
+            if (next > 0) {
+                ok = ahead.get();
+                buf[0].swap(buf[1]);
+            }
+            i = j;
+            k = next;
+        }
+        return ok;
+    }
+};
+
+/*
+ *  Semi-externe Algorithmen
+ */
+
+// Semi-externe Breitensuche: Im Speicher liegen nur level und pred (je
+// ein Eintrag pro Knoten), die Kanten werden in jedem Durchlauf
+// sequenziell aus es gelesen.
+// level[v] ist danach die Kantenzahl eines kürzesten Weges von s nach v
+// (NONE, wenn v nicht erreichbar ist), pred[v] der Vorgänger auf diesem
+// Weg (NONE beim Startknoten und bei nicht erreichten Knoten).
+// Bei undirected wird jede Kante in beiden Richtungen verwendet.
+// Jeder Durchlauf senkt level[v] für alle Kanten mit level[u] + 1 <
+// level[v], nicht nur für die aktuelle Front, bis ein Durchlauf nichts
+// mehr ändert. Damit sind höchstens Exzentrizität von s plus eins
+// Durchläufe nötig, bei günstiger Kantenreihenfolge (z. B. nach
+// Startknoten in Breitensuchreihenfolge) oft deutlich weniger.
+// Resultatwert: Anzahl der Durchläufe (0 bei einem Lesefehler).
+inline uint externalBfs (EdgeStream& es, uint s, vector<uint>& level,
+                         vector<uint>& pred, bool undirected = false) {
+    level.assign(es.n, NONE);
+    pred.assign(es.n, NONE);
+    level[s] = 0;
+    uint passes = 0;
+    bool changed = true;
+    auto relax = [&] (uint u, uint v) {
+        if (level[u] != NONE && level[u] + 1 < level[v]) {
+            level[v] = level[u] + 1;
+            pred[v] = u;
+            changed = true;
+        }
+    };
+    while (changed) {
+        changed = false;
+        passes++;
+        bool ok = es.scan([&] (uint u, uint v) {
+            relax(u, v);
+            if (undirected) relax(v, u);
+        });
+        if (!ok) return 0;
+    }
+    return passes;
+}
+
+// Semi-externe Zusammenhangskomponenten (Kanten ungerichtet
+// aufgefasst) mit einem einzigen Durchlauf über die Kanten: Im Speicher
+// liegt nur die Union-Find-Struktur über den Knoten.
+// labels[v] ist danach der kleinste Knotenindex der Komponente von v
+// (wie bei cc).
+// Resultatwert: Anzahl der Komponenten (0 bei einem Lesefehler).
+inline uint externalCc (EdgeStream& es, vector<uint>& labels) {
+    UnionFind uf(es.n);
+    if (!es.scan([&] (uint u, uint v) { uf.unite(u, v); })) return 0;
+    labels.resize(es.n);
+    uint count = 0;
+    for (uint v = 0; v < es.n; v++) {
+        labels[v] = uf.find(v);
+        if (labels[v] == v) count++;
+    }
+    return count;
+}
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "csr.h"
+
+/*
+ *  Maximale Flüsse
+ */
+
+// Residualgraph im CSR-Format: Zu jeder Kante (u, v) des Ausgangsgraphen
+// gibt es einen Vorwärtsbogen u -> v mit der Kapazität der Kante und
+// einen Rückwärtsbogen v -> u mit Kapazität 0. rev[a] ist der jeweils
+// gepaarte Bogen, cap[a] die verbleibende (Residual-)Kapazität.
+// Die Bögen des Knotens u stehen zwischen off[u] und off[u + 1].
+struct Residual {
+    uint n = 0;
+    vector<uint> off, to, rev;
+    vector<double> cap;
+
+    // fwd[e] ist der Vorwärtsbogen zur Kante an Position e des
+    // Ausgangsgraphen.
+    vector<uint> fwd;
+
+    // Residualgraph zum Graphen g mit den Kantengewichten als
+    // Kapazitäten aufbauen.
+    template <typename V>
+    explicit Residual (const FrozenGraph<V>& g) : n(g.size()) {
+        off.assign(n + 1, 0);
+        for (uint u = 0; u < n; u++) {
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                off[u + 1]++;
+                off[g.tgt[e] + 1]++;
+            }
+        }
+        for (uint u = 0; u < n; u++) off[u + 1] += off[u];
+
+        to.resize(off[n]);
+        rev.resize(off[n]);
+        cap.resize(off[n]);
+        fwd.resize(g.edges());
+        vector<uint> pos(off.begin(), off.end() - 1);
+        for (uint u = 0; u < n; u++) {
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                uint v = g.tgt[e];
+                uint a = pos[u]++, b = pos[v]++;
+                to[a] = v;
+                to[b] = u;
+                rev[a] = b;
+                rev[b] = a;
+                cap[a] = g.weight(e);
+                cap[b] = 0;
+                fwd[e] = a;
+            }
+        }
+    }
+
+    // Bogen a um f entlasten und den gepaarten Bogen um f belasten.
+    void push (uint a, double f) {
+        cap[a] -= f;
+        cap[rev[a]] += f;
+    }
+};
+
+// Ergebnis von pushRelabel und dinic: Wert des maximalen Flusses, Fluss
+// auf jeder Kante (nach Position im CSR-Format des Ausgangsgraphen) und
+// die Quellseite eines minimalen Schnitts (cut[v] ist true für alle
+// Knoten, die im Residualgraphen von der Quelle aus erreichbar sind).
+// Quelle und Senke müssen verschieden sein; für s == t liefern beide
+// Verfahren den Wert 0, einen Fluss von 0 auf jeder Kante und einen
+// leeren Schnitt.
+struct MaxFlow {
+    double value = 0;
+    vector<double> flow;
+    vector<bool> cut;
+};
+
+// Ergebnis für s == t (siehe MaxFlow) in res speichern.
+template <typename V>
+void emptyFlow (const FrozenGraph<V>& g, MaxFlow& res) {
+    res.value = 0;
+    res.flow.assign(g.edges(), 0);
+    res.cut.clear();
+}
+
+// Fluss je Kante und minimalen Schnitt aus dem Residualgraphen r des
+// Graphen g ablesen und in res speichern.
+template <typename V>
+void extractFlow (const FrozenGraph<V>& g, const Residual& r, uint s,
+                  MaxFlow& res) {
+    res.flow.resize(g.edges());
+    for (uint e = 0; e < g.edges(); e++) {
+        res.flow[e] = max(0.0, g.weight(e) - r.cap[r.fwd[e]]);
+    }
+
+    res.cut.assign(r.n, false);
+    vector<uint> q = { s };
+    res.cut[s] = true;
+    for (size_t i = 0; i < q.size(); i++) {
+        uint u = q[i];
+        for (uint a = r.off[u]; a < r.off[u + 1]; a++) {
+            if (r.cap[a] > 0 && !res.cut[r.to[a]]) {
+                res.cut[r.to[a]] = true;
+                q.push_back(r.to[a]);
+            }
+        }
+    }
+}
+
+// Maximalen Fluss von s nach t (Indizes) im Graphen g mit den
+// Kantengewichten als Kapazitäten mit dem Push-Relabel-Verfahren
+// ermitteln und das Ergebnis in res speichern.
+// Heuristiken:
+// - Highest-Label: Es wird immer ein aktiver Knoten mit maximaler
+//   Höhe bearbeitet (Eimer je Höhe).
+// - Globales Umbenennen: Die Höhen werden zu Beginn und danach nach
+//   jeweils n Umbenennungen durch eine Breitensuche rückwärts von t
+//   aus auf die exakten Residualdistanzen gesetzt. Knoten, die t nicht
+//   mehr erreichen, erhalten durch eine zweite Breitensuche rückwärts
+//   von s aus die Höhe n + Residualdistanz zu s, damit ihr Überschuss
+//   zur Quelle zurückfließt (auf n zurückgesetzt würden sie immer
+//   wieder neu angehoben, ohne dass der Algorithmus endet).
+// - Lückenheuristik: Wird eine Höhe h < n leer, können Knoten oberhalb
+//   von h die Senke nicht mehr erreichen und werden sofort auf n + 1
+//   angehoben.
+// Die Kapazitäten dürfen nicht negativ sein.
+template <typename V>
+void pushRelabel (const FrozenGraph<V>& g, uint s, uint t, MaxFlow& res) {
+    if (s == t) {
+        emptyFlow(g, res);
+        return;
+    }
+    Residual r(g);
+    uint n = r.n;
+    vector<uint> height(n, 0), current(r.off.begin(), r.off.end() - 1);
+    vector<uint> count(2 * n + 1, 0);
+    vector<double> excess(n, 0);
+    vector<vector<uint>> active(2 * n + 1);
+    vector<bool> queued(n, false);
+    uint top = 0;
+
+    auto activate = [&] (uint v) {
+        if (v == s || v == t || queued[v] || height[v] >= 2 * n) return;
+        queued[v] = true;
+        active[height[v]].push_back(v);
+        top = max(top, height[v]);
+    };
+
+    auto globalRelabel = [&] {
+        fill(height.begin(), height.end(), 2 * n);
+        fill(count.begin(), count.end(), 0);
+        auto search = [&] (uint root, uint h) {
+            height[root] = h;
+            vector<uint> q = { root };
+            for (size_t i = 0; i < q.size(); i++) {
+                uint u = q[i];
+                for (uint a = r.off[u]; a < r.off[u + 1]; a++) {
+                    uint x = r.to[a];
+                    if (r.cap[r.rev[a]] > 0 && height[x] == 2 * n && x != s) {
+                        height[x] = height[u] + 1;
+                        q.push_back(x);
+                    }
+                }
+            }
+        };
+        search(t, 0);
+        search(s, n);
+        for (uint v = 0; v < n; v++) {
+            count[height[v]]++;
+            current[v] = r.off[v];
+        }
+        for (auto& b : active) b.clear();
+        fill(queued.begin(), queued.end(), false);
+        top = 0;
+        for (uint v = 0; v < n; v++) {
+            if (excess[v] > 0) activate(v);
+        }
+    };
+
+    // Quelle sättigen.
+    for (uint a = r.off[s]; a < r.off[s + 1]; a++) {
+        double c = r.cap[a];
+        if (c <= 0) continue;
+        r.push(a, c);
+        excess[r.to[a]] += c;
+        excess[s] -= c;
+    }
+    globalRelabel();
+
+    uint relabels = 0;
+    for (;;) {
+        while (top > 0 && active[top].empty()) top--;
+        if (active[top].empty()) break;
+        uint u = active[top].back();
+        active[top].pop_back();
+        queued[u] = false;
+
+        // Knoten u entladen.
+        while (excess[u] > 0) {
+            if (current[u] == r.off[u + 1]) {
+                // Umbenennen.
+                uint old = height[u], h = 2 * n;
+                for (uint a = r.off[u]; a < r.off[u + 1]; a++) {
+                    if (r.cap[a] > 0) h = min(h, height[r.to[a]] + 1);
+                }
+                count[old]--;
+                height[u] = h;
+                if (h < 2 * n) count[h]++;
+                current[u] = r.off[u];
+                relabels++;
+
+                if (count[old] == 0 && old < n) {
+                    // Lücke: alle Knoten zwischen old und n abheben.
+                    for (uint v = 0; v < n; v++) {
+                        if (height[v] > old && height[v] < n) {
+                            count[height[v]]--;
+                            height[v] = n + 1;
+                            count[n + 1]++;
+                        }
+                    }
+                    if (height[u] < n + 1) {
+                        count[height[u]]--;
+                        height[u] = n + 1;
+                        count[n + 1]++;
+                    }
+                }
+                if (height[u] >= 2 * n) break;
+                continue;
+            }
+
+            uint a = current[u];
+            uint v = r.to[a];
+            if (r.cap[a] > 0 && height[u] == height[v] + 1) {
+                double f = min(excess[u], r.cap[a]);
+                r.push(a, f);
+                excess[u] -= f;
+                excess[v] += f;
+                activate(v);
+            } else {
+                current[u]++;
+            }
+        }
+
+        if (relabels >= n) {
+            relabels = 0;
+            globalRelabel();
+        } else if (excess[u] > 0) {
+            activate(u);
+        }
+    }
+
+    res.value = excess[t];
+    extractFlow(g, r, s, res);
+}
+
+// Maximalen Fluss von s nach t (Indizes) im Graphen g mit den
+// Kantengewichten als Kapazitäten mit dem Algorithmus von Dinic
+// ermitteln und das Ergebnis in res speichern.
+// Jede Phase bestimmt durch eine Breitensuche im Residualgraphen die
+// Ebenen der Knoten und danach einen blockierenden Fluss entlang von
+// Bögen, die genau eine Ebene tiefer führen. Die Wegsuche ist iterativ
+// und merkt sich je Knoten den aktuellen Bogen, sodass jeder Bogen pro
+// Phase nur einmal verworfen wird.
+// Die Kapazitäten dürfen nicht negativ sein.
+template <typename V>
+void dinic (const FrozenGraph<V>& g, uint s, uint t, MaxFlow& res) {
+    if (s == t) {
+        emptyFlow(g, res);
+        return;
+    }
+    Residual r(g);
+    uint n = r.n;
+    vector<uint> level(n), current(n), path, q;
+    res.value = 0;
+
+    for (;;) {
+        // Ebenen bestimmen.
+        fill(level.begin(), level.end(), NONE);
+        level[s] = 0;
+        q.assign(1, s);
+        for (size_t i = 0; i < q.size(); i++) {
+            uint u = q[i];
+            for (uint a = r.off[u]; a < r.off[u + 1]; a++) {
+                if (r.cap[a] > 0 && level[r.to[a]] == NONE) {
+                    level[r.to[a]] = level[u] + 1;
+                    q.push_back(r.to[a]);
+                }
+            }
+        }
+        if (level[t] == NONE) break;
+
+        // Blockierenden Fluss finden.
+        for (uint u = 0; u < n; u++) current[u] = r.off[u];
+        path.clear();
+        uint u = s;
+        for (;;) {
+            if (u == t) {
+                double f = r.cap[path[0]];
+                for (uint a : path) f = min(f, r.cap[a]);
+                for (uint a : path) r.push(a, f);
+                res.value += f;
+                // Bis vor den ersten gesättigten Bogen zurückgehen.
+                size_t k = 0;
+                while (r.cap[path[k]] > 0) k++;
+                path.resize(k);
+                u = k ? r.to[path[k - 1]] : s;
+                continue;
+            }
+
+            uint& a = current[u];
+            while (a < r.off[u + 1] && !(r.cap[a] > 0
+                    && level[r.to[a]] == level[u] + 1)) {
+                a++;
+            }
+            if (a < r.off[u + 1]) {
+                path.push_back(a);
+                u = r.to[a];
+                continue;
+            }
+
+            // Sackgasse: u für diese Phase sperren und zurückgehen.
+            if (u == s) break;
+            level[u] = NONE;
+            path.pop_back();
+            u = path.empty() ? s : r.to[path.back()];
+        }
+    }
+
+    extractFlow(g, r, s, res);
+}
+
+// Ergebnis von maxFlow für einen gewichteten Graphen: Wert des maximalen
+// Flusses, Fluss flow[{u, v}] auf jeder Kante (u, v) (bei mehrfach
+// eingetragenen Nachfolgern die Summe) und die Knoten cut der
+// Quellseite eines minimalen Schnitts.
+template <typename V>
+struct Flow {
+    double value = 0;
+    map<pair<V, V>, double> flow;
+    set<V> cut;
+};
+
+// Maximalen Fluss von s nach t im gewichteten Graphen g mit den
+// Kantengewichten als Kapazitäten ermitteln (mit pushRelabel bzw., falls
+// useDinic, mit dinic) und das Ergebnis in res speichern.
+// Kommt s oder t in g nicht vor, ist das Ergebnis dasselbe wie für
+// s == t (siehe MaxFlow).
+template <typename V>
+void maxFlow (WeightedGraph<V>& g, V s, V t, Flow<V>& res,
+              bool useDinic = false) {
+    FrozenGraph<V> f = freeze(g);
+    uint a = f.index(s), b = f.index(t);
+    MaxFlow m;
+    if (a == NONE || b == NONE) emptyFlow(f, m);
+    else if (useDinic) dinic(f, a, b, m);
+    else pushRelabel(f, a, b, m);
+
+    res.value = m.value;
+    res.flow.clear();
+    res.cut.clear();
+    for (uint u = 0; u < f.size(); u++) {
+        for (uint e = f.off[u]; e < f.off[u + 1]; e++) {
+            res.flow[{ f.vs[u], f.vs[f.tgt[e]] }] += m.flow[e];
+        }
+    }
+    for (uint v = 0; v < m.cut.size(); v++) {
+        if (m.cut[v]) res.cut.insert(f.vs[v]);
+    }
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <limits>
 #include <list>
 #include <map>
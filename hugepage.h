@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <utility>	// pair
+#include <vector>
+
+#include <sys/mman.h>
+
+/*
+ *  Große Speicherseiten für große Felder
+ */
+
+// Art der Seiten für große Felder (ab HUGE_MIN Bytes):
+// HUGE_OFF: gewöhnliche Speicherverwaltung (operator new),
+// HUGE_THP: transparente große Seiten (auf 2 MB ausgerichteter Bereich
+//           mit madvise(MADV_HUGEPAGE)),
+// HUGE_2MB, HUGE_1GB: explizite große Seiten (MAP_HUGETLB) aus dem vom
+//           Administrator reservierten Vorrat.
+// Gelingt eine Art nicht (z. B. weil keine expliziten Seiten reserviert
+// sind), wird die nächstschwächere versucht (1 GB, 2 MB, THP, new).
+enum HugePages { HUGE_OFF, HUGE_THP, HUGE_2MB, HUGE_1GB };
+
+constexpr size_t HUGE_MIN = size_t(2) << 20;
+
+// Einstellung für alle danach angeforderten großen Felder
+// (voreingestellt: HUGE_OFF).
+inline atomic<int>& hugePages () {
+    static atomic<int> mode(HUGE_OFF);
+    return mode;
+}
+
+// Verwaltung der über mmap angeforderten Bereiche: Länge und
+// tatsächlich verwendete Seitenart jedes Bereichs sowie die Summe der
+// Bytes je Seitenart (für Auswertungen).
+struct HugeRegistry {
+    mutex lock;
+    map<void*, pair<size_t, int>> regions;
+    size_t bytes[4] = { 0, 0, 0, 0 };
+
+    static HugeRegistry& get () {
+        static HugeRegistry r;
+        return r;
+    }
+};
+
+// Bereich mit mindestens bytes Bytes mit der Seitenart mode anfordern
+// (ggf. schwächere Art, siehe HugePages); nullptr, wenn auch mmap ohne
+// große Seiten scheitert. used ist danach die tatsächliche Seitenart.
+inline void* hugeMap (size_t bytes, int mode, size_t& len, int& used) {
+    const size_t mb2 = size_t(2) << 20, gb1 = size_t(1) << 30;
+    int prot = PROT_READ | PROT_WRITE, flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if (mode == HUGE_1GB) {
+        len = (bytes + gb1 - 1) / gb1 * gb1;
+        void* p = mmap(nullptr, len, prot,
+                       flags | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+        if (p != MAP_FAILED) {
+            used = HUGE_1GB;
+            return p;
+        }
+        mode = HUGE_2MB;
+    }
+    if (mode == HUGE_2MB) {
+        len = (bytes + mb2 - 1) / mb2 * mb2;
+        void* p = mmap(nullptr, len, prot,
+                       flags | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+        if (p != MAP_FAILED) {
+            used = HUGE_2MB;
+            return p;
+        }
+    }
+#endif
+    // Transparente große Seiten: Bereich mit Reserve anfordern und auf
+    // 2 MB ausgerichtet zuschneiden, damit er ganz aus großen Seiten
+    // bestehen kann.
+    len = (bytes + mb2 - 1) / mb2 * mb2;
+    char* raw = static_cast<char*>(mmap(nullptr, len + mb2, prot, flags, -1, 0));
+    if (raw == MAP_FAILED) return nullptr;
+    char* p = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(raw) + mb2 - 1) & ~(mb2 - 1));
+    if (p > raw) munmap(raw, p - raw);
+    if (raw + len + mb2 > p + len) munmap(p + len, raw + len + mb2 - (p + len));
+    used = HUGE_OFF;
+#ifdef MADV_HUGEPAGE
+    if (madvise(p, len, MADV_HUGEPAGE) == 0) used = HUGE_THP;
+#endif
+    return p;
+}
+
+// Speicher für große Felder gemäß hugePages() anfordern bzw. freigeben.
+inline void* hugeAlloc (size_t bytes) {
+    int mode = hugePages().load(memory_order_relaxed);
+    if (mode == HUGE_OFF || bytes < HUGE_MIN) return ::operator new(bytes);
+    size_t len;
+    int used;
+    void* p = hugeMap(bytes, mode, len, used);
+    if (!p) throw bad_alloc();
+    HugeRegistry& r = HugeRegistry::get();
+    lock_guard<mutex> guard(r.lock);
+    r.regions[p] = { len, used };
+    r.bytes[used] += len;
+    return p;
+}
+
+inline void hugeFree (void* p, size_t bytes) {
+    if (bytes < HUGE_MIN) {
+        ::operator delete(p);
+        return;
+    }
+    HugeRegistry& r = HugeRegistry::get();
+    {
+        lock_guard<mutex> guard(r.lock);
+        auto it = r.regions.find(p);
+        if (it != r.regions.end()) {
+            munmap(p, it->second.first);
+            r.bytes[it->second.second] -= it->second.first;
+            r.regions.erase(it);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+// Allokator für std::vector, der große Felder gemäß hugePages() mit
+// großen Seiten anlegt. Weil jeder Bereich seine Herkunft selbst
+// verwaltet, darf die Einstellung jederzeit geändert werden; Felder
+// behalten die Seitenart, mit der sie angelegt wurden.
+template <typename T>
+struct HugeAllocator {
+    typedef T value_type;
+
+    HugeAllocator () {}
+    template <typename U>
+    HugeAllocator (const HugeAllocator<U>&) {}
+
+    T* allocate (size_t n) { return static_cast<T*>(hugeAlloc(n * sizeof(T))); }
+    void deallocate (T* p, size_t n) { hugeFree(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator== (const HugeAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!= (const HugeAllocator<U>&) const { return false; }
+};
+
+// Feld für große Datenmengen (Kanten eines FrozenGraph, Ergebnisfelder
+// von Suchen), das bei Bedarf große Seiten verwendet.
+template <typename T>
+using BigArray = vector<T, HugeAllocator<T>>;
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "csr.h"
+
+/*
+ *  Reparatur kürzester Wege nach Gewichtsänderungen
+ */
+
+// Kürzeste Wege von einem festen Startknoten s, die nach Änderungen von
+// Kantengewichten repariert statt neu berechnet werden (nach
+// Ramalingam und Reps).
+// Das Objekt besitzt eine eigene Kopie des Graphen (mit dem
+// transponierten Graphen für den Zugriff auf Vorgänger) und die
+// aktuellen Distanzen und Vorgänger als flache Felder.
+template <typename V>
+struct DynamicSSSP {
+    // Gewichtsänderung: Die Kante (u, v) erhält das Gewicht w.
+    struct Change {
+        V u, v;
+        double w;
+    };
+
+    FrozenGraph<V> g;
+    // Eingehende Kanten: Die Kanten nach v sind tin[toff[v]] bis
+    // tin[toff[v + 1] - 1] (Kantennummern von g), from[e] ist der
+    // Ausgangsknoten der Kante e.
+    vector<uint> toff, tin, from;
+    uint s;
+    vector<double> dist;
+    vector<uint> pred;
+
+    // Hilfsfelder einer Reparatur.
+    vector<bool> affected;
+    vector<uint> touched;
+    vector<pair<double, uint>> heap;
+
+    // Kürzeste Wege im Graphen g vom Startknoten s aus neu berechnen.
+    DynamicSSSP (const FrozenGraph<V>& g, V s) : g(g), s(g.index(s)) {
+        init();
+        Workspace ws;
+        dijkstra(this->g, this->s, ws);
+        for (uint v = 0; v < this->g.size(); v++) {
+            dist[v] = ws.distance(v);
+            pred[v] = ws.predecessor(v);
+        }
+    }
+
+    // Vorhandenes Ergebnis res von dijkstra oder bellmanFord für den
+    // Graphen g und den Startknoten s übernehmen.
+    DynamicSSSP (const FrozenGraph<V>& g, V s, SP<V>& res)
+            : g(g), s(g.index(s)) {
+        init();
+        for (uint v = 0; v < g.size(); v++) {
+            V x = g.vertex(v);
+            dist[v] = res.dist[x];
+            if (v != this->s && dist[v] != numeric_limits<double>::infinity()) {
+                pred[v] = g.index(res.pred[x]);
+            }
+        }
+    }
+
+    // Vorgängerlisten und Felder anlegen.
+    void init () {
+        uint n = g.size();
+        if (g.wt.empty()) g.wt.assign(g.edges(), 1);
+        toff.assign(n + 1, 0);
+        for (uint v : g.tgt) toff[v + 1]++;
+        for (uint v = 0; v < n; v++) toff[v + 1] += toff[v];
+        tin.resize(g.edges());
+        from.resize(g.edges());
+        vector<uint> pos(toff.begin(), toff.end() - 1);
+        for (uint u = 0; u < n; u++) {
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                tin[pos[g.tgt[e]]++] = e;
+                from[e] = u;
+            }
+        }
+        dist.assign(n, numeric_limits<double>::infinity());
+        pred.assign(n, NONE);
+        affected.assign(n, false);
+    }
+
+    // Distanz v verbessern und v in die Halde aufnehmen.
+    void improve (uint v, double d, uint u) {
+        if (!(d < dist[v])) return;
+        dist[v] = d;
+        pred[v] = u;
+        touched.push_back(v);
+        heap.push_back({ d, v });
+        push_heap(heap.begin(), heap.end(), HeapGreater());
+    }
+
+    // Gewichtsänderungen cs übernehmen, die kürzesten Wege reparieren
+    // und alle veränderten Distanzen und Vorgänger in res eintragen.
+    // (res muss vorher das Ergebnis für den alten Graphen enthalten,
+    // andere Einträge werden nicht angefasst.)
+    // Ablauf:
+    // 1. Erhöht sich das Gewicht einer Baumkante (pred[v] == u), ist
+    //    der ganze Teilbaum unter v betroffen: Seine Distanzen werden
+    //    verworfen und jeweils aus den nicht betroffenen Vorgängern neu
+    //    geschätzt.
+    // 2. Wird eine Kante (u, v) so billig, dass dist[u] + w < dist[v],
+    //    wird v mit dieser Distanz vorgemerkt.
+    // 3. Von allen vorgemerkten Knoten aus läuft Dijkstra, der nur
+    //    Knoten besucht, deren Distanz sich tatsächlich ändert.
+    // Die Kosten hängen damit nur von der Zahl der betroffenen Knoten
+    // und ihrer Kanten ab, nicht von der Größe des Graphen.
+    void update (const vector<Change>& cs, SP<V>& res) {
+        touched.clear();
+        heap.clear();
+        vector<uint> roots, lower;
+
+        for (auto& c : cs) {
+            uint u = g.index(c.u), v = g.index(c.v);
+            if (u == NONE || v == NONE) continue;
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                if (g.tgt[e] != v) continue;
+                double old = g.wt[e];
+                g.wt[e] = c.w;
+                if (c.w > old && pred[v] == u) roots.push_back(v);
+                else if (c.w < old) lower.push_back(e);
+            }
+        }
+
+        // Betroffene Teilbäume sammeln (Kinder eines Knotens x sind die
+        // Nachfolger y mit pred[y] == x).
+        vector<uint> sub;
+        for (uint r : roots) {
+            if (affected[r]) continue;
+            affected[r] = true;
+            sub.push_back(r);
+        }
+        for (size_t i = 0; i < sub.size(); i++) {
+            uint x = sub[i];
+            for (uint e = g.off[x]; e < g.off[x + 1]; e++) {
+                uint y = g.tgt[e];
+                if (pred[y] == x && !affected[y]) {
+                    affected[y] = true;
+                    sub.push_back(y);
+                }
+            }
+        }
+        for (uint x : sub) {
+            dist[x] = numeric_limits<double>::infinity();
+            pred[x] = NONE;
+            touched.push_back(x);
+        }
+        for (uint x : sub) {
+            for (uint p = toff[x]; p < toff[x + 1]; p++) {
+                uint e = tin[p], u = from[e];
+                if (!affected[u]) improve(x, dist[u] + g.wt[e], u);
+            }
+        }
+        for (uint x : sub) affected[x] = false;
+
+        for (uint e : lower) {
+            uint u = from[e];
+            improve(g.tgt[e], dist[u] + g.wt[e], u);
+        }
+
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), HeapGreater());
+            double d = heap.back().first;
+            uint u = heap.back().second;
+            heap.pop_back();
+            if (d > dist[u]) continue;
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                improve(g.tgt[e], d + g.wt[e], u);
+            }
+        }
+
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        for (uint v : touched) {
+            V x = g.vertex(v);
+            res.dist[x] = dist[v];
+            res.pred[x] = pred[v] == NONE ? res.NIL : g.vertex(pred[v]);
+        }
+    }
+};
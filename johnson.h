@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "apsp.h"
+#include "batch.h"
+
+/*
+ *  Algorithmus von Johnson
+ */
+
+// Knotenpotenziale h für den Graphen g mit dem Algorithmus von
+// Bellman-Ford ermitteln, als ob ein zusätzlicher Startknoten mit
+// Kanten des Gewichts 0 zu allen Knoten existierte.
+// Danach gilt für jede Kante (u, v): w(u, v) + h[u] - h[v] >= 0.
+// Resultatwert true, wenn es keinen Zyklus mit negativem Gewicht gibt,
+// andernfalls false.
+// (Die Runden brechen ab, sobald sich kein Potenzial mehr ändert; bei
+// Graphen ohne negative Kanten genügt daher eine einzige Runde.)
+template <typename V>
+bool potentials (const FrozenGraph<V>& g, vector<double>& h) {
+    uint n = g.size();
+    h.assign(n, 0);
+    for (uint round = 0; round <= n; round++) {
+        bool changed = false;
+        for (uint u = 0; u < n; u++) {
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                double d = h[u] + g.weight(e);
+                if (d < h[g.tgt[e]]) {
+                    h[g.tgt[e]] = d;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) return true;
+    }
+    return false;
+}
+
+// Graphen g mit den Potenzialen h in einen Graphen r mit den
+// nichtnegativen Gewichten w(u, v) + h[u] - h[v] umgewichten.
+// (r teilt die Knotennummerierung von g, besitzt aber keine
+// Tabelle idx.)
+template <typename V>
+void reweight (const FrozenGraph<V>& g, const vector<double>& h,
+               FrozenGraph<V>& r) {
+    r.vs = g.vs;
+    r.off = g.off;
+    r.tgt = g.tgt;
+    r.wt.resize(g.edges());
+    for (uint u = 0; u < g.size(); u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            // Rundungsfehler dürfen kein negatives Gewicht erzeugen.
+            r.wt[e] = max(0.0, g.weight(e) + h[u] - h[g.tgt[e]]);
+        }
+    }
+}
+
+// Kürzeste Wege von jedem Knoten des Graphen g aus mit dem Algorithmus
+// von Johnson ermitteln: einmal Bellman-Ford zur Umgewichtung, danach
+// Dijkstra von jedem Startknoten aus, parallel auf den Threads von
+// pool.
+// Für jeden Startknoten s (Index) wird f(s, ws) aufgerufen, wobei ws
+// die (bereits auf die ursprünglichen Gewichte zurückgerechneten)
+// Distanzen und Vorgänger der Suche enthält. f wird nebenläufig aus
+// mehreren Threads aufgerufen (siehe searchMany). Da nur ein
+// Arbeitsspeicher pro Thread existiert, bleibt der Speicherbedarf
+// unabhängig von der Anzahl der Startknoten O(n) pro Thread.
+// Die Kanten dürfen negative Gewichte besitzen.
+// Resultatwert true, wenn es keinen Zyklus mit negativem Gewicht
+// gibt, andernfalls false (dann wird f nie aufgerufen).
+template <typename V, typename F>
+bool johnsonStream (const FrozenGraph<V>& g, F f,
+                    ThreadPool& pool = defaultPool()) {
+    bool negative = false;
+    for (double w : g.wt) negative = negative || w < 0;
+
+    vector<double> h;
+    FrozenGraph<V> r;
+    const FrozenGraph<V>* dg = &g;
+    if (negative) {
+        if (!potentials(g, h)) return false;
+        reweight(g, h, r);
+        dg = &r;
+    }
+
+    vector<uint> sources(g.size());
+    for (uint s = 0; s < g.size(); s++) sources[s] = s;
+    searchMany(*dg, sources, [&] (const FrozenGraph<V>& dg, uint s,
+                                  Workspace& ws) {
+        dijkstra(dg, s, ws);
+        if (!negative) return;
+        for (uint v = 0; v < dg.size(); v++) {
+            if (ws.seen(v)) ws.dist[v] += h[v] - h[s];
+        }
+    }, [&] (size_t s, const Workspace& ws) { f(uint(s), ws); }, pool);
+    return true;
+}
+
+// Kürzeste Wege zwischen allen Knotenpaaren des Graphen g mit dem
+// Algorithmus von Johnson ermitteln und zeilenweise in res speichern
+// (mit Vorgängern, falls preds true ist).
+// Im Gegensatz zu apsp ist die Laufzeit O(n m log n), also für dünn
+// besetzte Graphen deutlich günstiger als O(n^3).
+// Resultatwert wie bei johnsonStream.
+template <typename V>
+bool johnson (const FrozenGraph<V>& g, DistMatrix& res, bool preds = true,
+              ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    res.init(n, n, preds);
+    return johnsonStream(g, [&] (uint s, const Workspace& ws) {
+        double* d = &res.dist[size_t(s) * n];
+        uint* p = preds ? &res.pred[size_t(s) * n] : nullptr;
+        for (uint v = 0; v < n; v++) {
+            if (!ws.seen(v)) continue;
+            d[v] = ws.dist[v];
+            if (preds) p[v] = ws.pred[v];
+        }
+    }, pool);
+}
+
+// Kürzeste Wege zwischen allen Knotenpaaren des gewichteten Graphen g
+// mit dem Algorithmus von Johnson ermitteln (siehe oben). Die
+// Knotenindizes von res entsprechen der Reihenfolge von g.vertices().
+template <typename V>
+bool johnson (WeightedGraph<V>& g, DistMatrix& res, bool preds = true,
+              ThreadPool& pool = defaultPool()) {
+    return johnson(freeze(g), res, preds, pool);
+}
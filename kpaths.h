@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <set>
+#include <utility>	// pair
+#include <vector>
+
+#include "bitset.h"
+#include "csr.h"
+
+/*
+ *  k kürzeste schleifenfreie Wege (Yen)
+ */
+
+// Weg in einem FrozenGraph: Gesamtgewicht, Knoten (einschließlich
+// Start- und Zielknoten) und verwendete Kanten (Positionen im
+// CSR-Format, eine weniger als Knoten).
+struct Path {
+    double cost = 0;
+    vector<uint> vs, es;
+};
+
+// Weg zum Knoten t aus dem Ergebnis ws einer Suche ablesen, die nur
+// Kanten mit use(e) verwendet hat, und an p anhängen.
+// (Bei Mehrfachkanten wird eine straffe, erlaubte Kante gewählt.)
+template <typename V, typename F>
+void appendPath (const FrozenGraph<V>& g, const Workspace& ws, uint t,
+                 F use, Path& p) {
+    vector<uint> vs;
+    ws.path(t, vs);
+    for (size_t i = 1; i < vs.size(); i++) {
+        uint u = vs[i - 1], v = vs[i];
+        uint best = NONE;
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            if (g.tgt[e] == v && use(e)
+                    && (best == NONE || g.weight(e) < g.weight(best))) {
+                best = e;
+            }
+        }
+        p.es.push_back(best);
+        p.vs.push_back(v);
+        p.cost += g.weight(best);
+    }
+}
+
+// Die k kürzesten schleifenfreien Wege vom Knoten s zum Knoten t
+// (Indizes) im Graphen g mit dem Algorithmus von Yen ermitteln und
+// nach aufsteigendem Gewicht in res speichern (weniger als k, wenn es
+// nicht so viele gibt).
+// Für jeden Knoten (Abzweigknoten) des zuletzt gefundenen Weges wird
+// eine Suche von dort nach t ausgeführt, bei der die Knoten des
+// gemeinsamen Anfangsstücks und die von dort schon benutzten Kanten
+// über Bitmengen ausgeblendet sind (dijkstraIf), statt jeweils eine
+// Kopie des Graphen ohne diese Knoten und Kanten zu erzeugen.
+// Jede Suche bricht ab, sobald t erreicht ist.
+// Die Kanten des Graphen dürfen keine negativen Gewichte besitzen.
+template <typename V>
+void kShortestPaths (const FrozenGraph<V>& g, uint s, uint t, uint k,
+                     vector<Path>& res) {
+    res.clear();
+    if (k == 0) return;
+
+    Workspace ws;
+    Bitset vmask(g.size()), emask(g.edges());
+    auto use = [&] (uint e) {
+        return !emask.test(e) && !vmask.test(g.tgt[e]);
+    };
+
+    dijkstraIf(g, s, ws, t, use);
+    if (!ws.seen(t)) return;
+    Path first;
+    first.vs.push_back(s);
+    appendPath(g, ws, t, use, first);
+    res.push_back(first);
+
+    // Kandidaten, geordnet nach Gewicht (und Kantenfolge, womit
+    // gleiche Wege nur einmal vorkommen).
+    set<pair<double, vector<uint>>> cand;
+
+    while (res.size() < k) {
+        const Path& last = res.back();
+        Path root;
+        root.vs.push_back(s);
+        for (size_t j = 0; j + 1 < last.vs.size(); j++) {
+            uint spur = last.vs[j];
+
+            // Kanten ausblenden, mit denen ein schon gefundener Weg mit
+            // demselben Anfangsstück den Abzweigknoten verlässt.
+            vector<uint> blocked;
+            for (const Path& p : res) {
+                if (p.es.size() > j && equal(root.es.begin(), root.es.end(),
+                                             p.es.begin())) {
+                    emask.set(p.es[j]);
+                    blocked.push_back(p.es[j]);
+                }
+            }
+            for (size_t i = 0; i < j; i++) vmask.set(root.vs[i]);
+
+            dijkstraIf(g, spur, ws, t, use);
+            if (ws.seen(t)) {
+                Path p = root;
+                appendPath(g, ws, t, use, p);
+                cand.insert({ p.cost, p.es });
+            }
+
+            for (uint e : blocked) emask.reset(e);
+            for (size_t i = 0; i < j; i++) vmask.reset(root.vs[i]);
+
+            // Anfangsstück um eine Kante des letzten Weges verlängern.
+            root.es.push_back(last.es[j]);
+            root.vs.push_back(last.vs[j + 1]);
+            root.cost += g.weight(last.es[j]);
+        }
+
+        if (cand.empty()) break;
+        Path next;
+        next.cost = cand.begin()->first;
+        next.es = cand.begin()->second;
+        cand.erase(cand.begin());
+        next.vs.push_back(s);
+        for (uint e : next.es) next.vs.push_back(g.tgt[e]);
+        res.push_back(next);
+    }
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "csr.h"
+
+/*
+ *  2-Hop-Distanzindex (Pruned Landmark Labeling)
+ */
+
+// Menge von Labels aller Knoten: Die Labels des Knotens v stehen an den
+// Positionen off[v] bis off[v + 1] - 1 von hub (Rang des Hub-Knotens,
+// aufsteigend sortiert) und dist (Distanz zwischen v und dem Hub).
+// Die Zeiger verweisen entweder in die Felder eines Labeling-Objekts
+// oder in eine eingeblendete Indexdatei.
+struct LabelSet {
+    const uint64_t* off = nullptr;
+    const uint32_t* hub = nullptr;
+    const double* dist = nullptr;
+};
+
+// Distanzindex nach dem Verfahren "Pruned Landmark Labeling".
+// Jeder Knoten v besitzt ein Ausgangslabel (Hubs h mit ihrer Distanz
+// d(v, h)) und ein Eingangslabel (Hubs h mit d(h, v)). Die Distanz von
+// u nach v ist das Minimum von d(u, h) + d(h, v) über alle Hubs h, die
+// im Ausgangslabel von u und im Eingangslabel von v vorkommen; weil
+// beide Listen nach Hub-Rang sortiert sind, ist das ein einfacher
+// Reißverschluss-Durchlauf zweier kurzer Listen.
+// Bei ungerichteten Graphen stimmen beide Labels überein und werden nur
+// einmal gespeichert.
+struct Labeling {
+    uint n = 0;
+    bool undirected = false;
+    LabelSet in, out;
+
+    // Eigene Speicherung (nach buildLabeling) ...
+    vector<uint64_t> inOff, outOff;
+    vector<uint32_t> inHub, outHub;
+    vector<double> inDist, outDist;
+
+    // ... bzw. eingeblendete Datei (nach load).
+    void* map = nullptr;
+    size_t mapSize = 0;
+
+    Labeling () = default;
+    Labeling (const Labeling&) = delete;
+    Labeling& operator= (const Labeling&) = delete;
+    ~Labeling () { unload(); }
+
+    // Distanz vom Knoten u zum Knoten v (Indizes) liefern
+    // (unendlich, wenn v von u aus nicht erreichbar ist).
+    double distance (uint u, uint v) const {
+        const LabelSet& a = undirected ? in : out;
+        uint64_t i = a.off[u], ie = a.off[u + 1];
+        uint64_t j = in.off[v], je = in.off[v + 1];
+        double best = numeric_limits<double>::infinity();
+        while (i < ie && j < je) {
+            if (a.hub[i] < in.hub[j]) i++;
+            else if (a.hub[i] > in.hub[j]) j++;
+            else best = min(best, a.dist[i++] + in.dist[j++]);
+        }
+        return best;
+    }
+
+    // Zeiger auf die eigenen Felder setzen.
+    void attach () {
+        in = { inOff.data(), inHub.data(), inDist.data() };
+        out = undirected ? in
+                         : LabelSet { outOff.data(), outHub.data(),
+                                      outDist.data() };
+    }
+
+    // Eingeblendete Datei freigeben.
+    void unload () {
+        if (map) munmap(map, mapSize);
+        map = nullptr;
+        mapSize = 0;
+    }
+
+    // Index im Binärformat in die Datei path schreiben.
+    // Aufbau: Kopf (Kennung, Flags, n, Anzahl der Eingangs- und
+    // Ausgangslabels) und danach je Labelmenge off, dist und hub, jeweils
+    // auf 8 Bytes ausgerichtet, sodass load die Datei unverändert
+    // einblenden kann.
+    // Resultatwert false bei einem Schreibfehler.
+    bool save (const char* path) const {
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+        uint64_t nin = in.off[n], nout = undirected ? 0 : out.off[n];
+        uint32_t head[2] = { MAGIC, undirected ? 1u : 0u };
+        uint64_t sizes[3] = { n, nin, nout };
+        bool ok = fwrite(head, sizeof(head), 1, f) == 1
+                  && fwrite(sizes, sizeof(sizes), 1, f) == 1
+                  && writeSet(f, in, nin)
+                  && (undirected || writeSet(f, out, nout));
+        return fclose(f) == 0 && ok;
+    }
+
+    // Index aus der Datei path einblenden (mmap, nur lesend).
+    // Die Labels werden erst beim Zugriff vom Betriebssystem geladen;
+    // beim Einblenden werden nur die Größen und die Anfänge (off) der
+    // Labels geprüft, damit eine abgeschnittene oder beschädigte Datei
+    // nicht zu Zugriffen außerhalb des eingeblendeten Bereichs führt.
+    // Resultatwert false, wenn die Datei fehlt oder ungültig ist.
+    bool load (const char* path) {
+        unload();
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) < 0 || size_t(st.st_size) < HEAD) {
+            close(fd);
+            return false;
+        }
+        void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED) return false;
+        map = m;
+        mapSize = st.st_size;
+
+        const char* p = static_cast<const char*>(map);
+        const uint32_t* head = reinterpret_cast<const uint32_t*>(p);
+        const uint64_t* sizes = reinterpret_cast<const uint64_t*>(p + 8);
+        if (head[0] != MAGIC || sizes[0] >= NONE) {
+            unload();
+            return false;
+        }
+        n = sizes[0];
+        undirected = head[1] & 1;
+        size_t pos = HEAD;
+        if (!mapSet(in, sizes[1], pos)
+                || (!undirected && !mapSet(out, sizes[2], pos))) {
+            unload();
+            return false;
+        }
+        if (undirected) out = in;
+        return true;
+    }
+
+    static constexpr uint32_t MAGIC = 0x314c4c50;	// "PLL1"
+    static constexpr size_t HEAD = 32;
+
+    // Platzbedarf einer Labelmenge mit k Labels in der Datei
+    // (auf 8 Bytes aufgerundet).
+    size_t setSize (uint64_t k) const {
+        return ((uint64_t(n) + 1) * 8 + k * 8 + k * 4 + 7) / 8 * 8;
+    }
+
+    bool writeSet (FILE* f, const LabelSet& s, uint64_t k) const {
+        static const char pad[8] = {};
+        size_t raw = (uint64_t(n) + 1) * 8 + k * 12;
+        return fwrite(s.off, 8, uint64_t(n) + 1, f) == uint64_t(n) + 1
+               && fwrite(s.dist, 8, k, f) == k
+               && fwrite(s.hub, 4, k, f) == k
+               && fwrite(pad, 1, setSize(k) - raw, f) == setSize(k) - raw;
+    }
+
+    // Labelmenge mit k Labels ab Position pos der eingeblendeten Datei
+    // übernehmen. Resultatwert false, wenn sie nicht ganz in der Datei
+    // liegt oder ihre Anfänge nicht von 0 bis k aufsteigen.
+    bool mapSet (LabelSet& s, uint64_t k, size_t& pos) {
+        if (uint64_t(n) + 1 > mapSize / 8 || k > mapSize / 12
+                || pos + setSize(k) > mapSize) {
+            return false;
+        }
+        const char* p = static_cast<const char*>(map) + pos;
+        size_t offBytes = (uint64_t(n) + 1) * 8;
+        s.off = reinterpret_cast<const uint64_t*>(p);
+        s.dist = reinterpret_cast<const double*>(p + offBytes);
+        s.hub = reinterpret_cast<const uint32_t*>(p + offBytes + k * 8);
+        pos += setSize(k);
+        if (s.off[0] != 0 || s.off[n] != k) return false;
+        for (uint v = 0; v < n; v++) {
+            if (s.off[v] > s.off[v + 1]) return false;
+        }
+        return true;
+    }
+};
+
+// Hilfsfunktion für buildLabeling: Beschnittene Suche vom Hub h mit
+// Rang r im Graphen g. Jeder erreichte Knoten v, dessen Distanz d(h, v)
+// sich nicht schon aus den bisherigen Labels ergibt (hubDist enthält
+// dafür das Gegenlabel von h, nach Hub-Rang), erhält das Label (r, d)
+// in labels[v] und wird weiter expandiert; alle anderen werden
+// abgeschnitten. Bei ungewichteten Graphen ist die Suche eine
+// Breitensuche, sonst Dijkstra.
+template <typename V>
+void prunedSearch (const FrozenGraph<V>& g, uint h, uint r,
+                   const vector<double>& hubDist,
+                   vector<vector<pair<uint32_t, double>>>& labels,
+                   Workspace& ws) {
+    auto covered = [&] (uint v, double d) {
+        for (auto& l : labels[v]) {
+            if (hubDist[l.first] + l.second <= d) return true;
+        }
+        return false;
+    };
+
+    ws.reset(g.size());
+    ws.set(h, 0, NONE);
+    if (g.weighted()) {
+        ws.heap.push_back({ 0, h });
+        while (!ws.heap.empty()) {
+            pop_heap(ws.heap.begin(), ws.heap.end(), HeapGreater());
+            double d = ws.heap.back().first;
+            uint u = ws.heap.back().second;
+            ws.heap.pop_back();
+            if (d > ws.dist[u] || covered(u, d)) continue;
+            labels[u].push_back({ r, d });
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                uint v = g.tgt[e];
+                double dv = d + g.weight(e);
+                if (dv < ws.distance(v)) {
+                    ws.set(v, dv, u);
+                    ws.heap.push_back({ dv, v });
+                    push_heap(ws.heap.begin(), ws.heap.end(), HeapGreater());
+                }
+            }
+        }
+    } else {
+        ws.queue.push_back(h);
+        for (size_t i = 0; i < ws.queue.size(); i++) {
+            uint u = ws.queue[i];
+            double d = ws.dist[u];
+            if (covered(u, d)) continue;
+            labels[u].push_back({ r, d });
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                uint v = g.tgt[e];
+                if (!ws.seen(v)) {
+                    ws.set(v, d + 1, u);
+                    ws.queue.push_back(v);
+                }
+            }
+        }
+    }
+}
+
+// Labels labels in die flachen Felder off, hub und dist übertragen.
+inline void flatten (vector<vector<pair<uint32_t, double>>>& labels,
+                     vector<uint64_t>& off, vector<uint32_t>& hub,
+                     vector<double>& dist) {
+    off.assign(labels.size() + 1, 0);
+    for (size_t v = 0; v < labels.size(); v++) {
+        off[v + 1] = off[v] + labels[v].size();
+    }
+    hub.resize(off.back());
+    dist.resize(off.back());
+    for (size_t v = 0; v < labels.size(); v++) {
+        uint64_t k = off[v];
+        for (auto& l : labels[v]) {
+            hub[k] = l.first;
+            dist[k++] = l.second;
+        }
+        vector<pair<uint32_t, double>>().swap(labels[v]);
+    }
+}
+
+// Distanzindex für den Graphen g aufbauen und in res speichern.
+// Die Knoten werden nach absteigendem Grad (Eingangs- plus
+// Ausgangsgrad) als Hubs verwendet, weil gut vernetzte Knoten auf
+// vielen kürzesten Wegen liegen und spätere Suchen dann früh
+// abgeschnitten werden. Für jeden Hub h wird eine beschnittene Suche
+// vorwärts (Eingangslabels der erreichten Knoten) und, bei gerichteten
+// Graphen, rückwärts im transponierten Graphen (Ausgangslabels)
+// ausgeführt.
+// Mit undirected = true muss jede Kante in beiden Richtungen mit dem
+// gleichen Gewicht vorhanden sein.
+// Die Kanten des Graphen dürfen keine negativen Gewichte besitzen.
+template <typename V>
+void buildLabeling (const FrozenGraph<V>& g, Labeling& res,
+                    bool undirected = false) {
+    uint n = g.size();
+    res.unload();
+    res.n = n;
+    res.undirected = undirected;
+
+    FrozenGraph<V> t;
+    if (!undirected) t = g.transpose();
+
+    vector<uint> order(n), deg(n, 0);
+    for (uint v = 0; v < n; v++) {
+        order[v] = v;
+        deg[v] += g.off[v + 1] - g.off[v];
+        for (uint e = g.off[v]; e < g.off[v + 1]; e++) deg[g.tgt[e]]++;
+    }
+    stable_sort(order.begin(), order.end(),
+                [&] (uint a, uint b) { return deg[a] > deg[b]; });
+
+    vector<vector<pair<uint32_t, double>>> in(n), out(undirected ? 0 : n);
+    vector<double> hubDist(n, numeric_limits<double>::infinity());
+    Workspace ws;
+    for (uint r = 0; r < n; r++) {
+        uint h = order[r];
+
+        // Vorwärts: Labels (r, d(h, v)) für Eingangslabels; zum
+        // Abschneiden dient das Ausgangslabel von h.
+        auto& hout = undirected ? in[h] : out[h];
+        for (auto& l : hout) hubDist[l.first] = l.second;
+        prunedSearch(g, h, r, hubDist, in, ws);
+        for (auto& l : hout) hubDist[l.first] = numeric_limits<double>::infinity();
+
+        if (undirected) continue;
+        // Rückwärts: Labels (r, d(v, h)) für Ausgangslabels.
+        for (auto& l : in[h]) hubDist[l.first] = l.second;
+        prunedSearch(t, h, r, hubDist, out, ws);
+        for (auto& l : in[h]) hubDist[l.first] = numeric_limits<double>::infinity();
+    }
+
+    flatten(in, res.inOff, res.inHub, res.inDist);
+    if (!undirected) flatten(out, res.outOff, res.outHub, res.outDist);
+    res.attach();
+}
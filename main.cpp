@@ -1 +1 @@
-#include <iostream>#include <string>using namespace std;#include "graph.h"// Knotentyp.using V = string;// Feld mit Testgraphen.// (Für eigene Tests können beliebige weitere Graphen hinzugefügt werden.)// Damit Graphen der Typen Graph<V> und WeightedGraph<V> im selben Feld// gespeichert werden können, werden Zeiger auf den Basistyp Graph<V>// gespeichert, die bei Bedarf in Zeiger auf WeightedGraph<V>// umgewandelt werden.Graph<V>* graphs [] = {        // Beispiel eines ungewichteten Graphen.        new Graph<string>({ //Beispiel                                  { "A", { "B", "C" } },                                  { "B", { } },                                  { "C", { "D" } },                                  { "D", { "E" } },                                  { "E", {  } }                          }),        new Graph<string>({ //Aufgabe 9 b                                  { "A", { "B", "H" } },                                  { "B", {"C", "F"} },                                  { "C", { "D", "G" } },                                  { "D", { "E", "G", "H"} },                                  { "E", {  } },                                  { "F", { "A", "B", "G"} },                                  { "G", { "H" } },                                  { "H", { "C" } }                          }),        new Graph<string>({ //Aufgabe 9 a                                  { "A", { "A", "B" } },                                  { "B", {"A", "C", "D"} },                                  { "C", { "B", "D" } },                                  { "D", { "B"} },                                  { "E", { "D", "F" } },                                  { "F", { "E", "F"} }                                  }),        // Beispiel eines gewichteten Graphen.        new WeightedGraph<string>({ //Beispiel                                          { "A", { { "B", 2 }, { "C", 3 } } },                                          { "B", { } },                                          { "C", { { "C", 4 } } }                                  }),        new WeightedGraph<string>({ //Jonas Graph                                          { "A", { { "B", 3 }, { "E", 1 }, { "F", 5 } } },                                          { "B", { { "A", 3}, { "C",8}, { "D", 7 }, { "E", 2 }, { "F", 5 }} },                                          { "C", { { "B", 8 }, { "D", 5 }, { "E", 7 } } },                                          { "D", { { "B", 7 }, { "C", 5 }, { "E", 8 } } },                                          { "E", { { "A", 1 }, { "B", 2 }, { "C", 7 }, { "D", 8 }, { "F", 4 } } },                                          { "F", { { "A", 5 }, { "B", 5 }, { "E", 4 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 13 Djik                                          { "A", { { "B", 10 }, { "E", 5 } } },                                          { "B", { { "C", 1}, { "E",2} } },                                          { "C", { { "D", 4 } } },                                          { "D", { { "A", 7 }, { "C", 6 } } },                                          { "E", { { "B", 3 }, { "C", 9 }, { "D", 2 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 12 Bellman                                          { "A", { { "B", 6 }, { "E", 7 } } },                                          { "B", { { "C", 5}, { "D",-4}, { "E",8} } },                                          { "C", { { "B", -2 } } },                                          { "D", { { "A", 2 }, { "C", 7 } } },                                          { "E", {  { "C", -3 }, { "D", 9 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 11 Prim                                          { "A", { { "A", 10 }, { "B", 4 }, {"H", 8} } },                                          { "B", { { "A", 4}, { "C",8}, { "H",11} } },                                          { "C", { { "B", 8 }, {"D", 7}, {"F", 4}, {"I", 2} } },                                          { "D", { { "C", 7 }, { "E", 9 }, {"F", 14} } },                                          { "E", {  { "D", 9 }, { "F", 10 } } },                                          { "F", {  { "C", 4 }, { "D", 14 }, {"G", 2} } },                                          { "G", {  { "F", 2 }, {"H", 1}, { "I", 6 } } },                                          { "H", {  {"A", 8}, {"B", 11}, { "G", 1 }, { "I", 7 } } },                                          { "I", {  { "C", 2 }, { "G", 6 }, {"H", 7} } },                                  }),        new WeightedGraph<string>({ //Aufgabe 12 Bellman mit cylce                                          { "A", { { "B", 1 }, { "C", 1 } } },                                          { "B", { { "C", -1} } },                                          { "C", { { "B", -1 } } }                                  }),};// Weg vom Startknoten s zum Knoten v anhand der Vorgängerinformation// in res ausgeben.void path (V s, V v, Pred<V>& res) {    if (s != v && res.pred[v] != res.NIL) {        path(s, res.pred[v], res);        cout << " -> ";    }    cout << v;}// Hauptprogramm.// Auswahl des Algorithmus durch das erste Kommandozeilenargument:// bfs -> breadth first search// dfs -> depth first search// sort -> topological sort// scc -> strongly connected components// prim -> Prim// bell -> Bellman-Ford// dijk -> Dijkstra// Auswahl des Testgraphen durch das zweite Kommandozeilenargument.// (Bei den Algorithmen prim, bell und dijk muss ein gewichteter// Graph ausgewählt werden.)// Auswahl des Startknotens durch das optionale dritte// Kommandozeilenargument (Standardwert ist "A").int main (int argc, char* argv []) {    // Kommandozeilenargumente.    //string a = argv[1];				// Algorithmus.    string a = argv[1];				// Algorithmus.    Graph<V>* g = graphs[stoi( argv[2])];	// Graph.    V s = argc > 3 ? argv[3] : "A";		// Startknoten.    // Gewünschten Algorithmus ausführen und sein Ergebnis ausgeben.    if (a == "bfs") {        BFS<V> res;        bfs(*g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            uint d = res.dist[v];            if (d == res.INF) cout << " inf" << endl;            else cout << " " << d << endl;        }    }    else if (a == "dfs") {        DFS<V> res;        dfs(*g, res);        for (V v : res.seq) {            cout << v << " " << res.det[v] << " " << res.fin[v] << endl;        }    }    else if (a == "sort") {        list<V> res;        if (topsort(*g, res)) {            for (V v : res) cout << v << endl;        }        else {            cout << "cycle" << endl;        }    }    else if (a == "scc") {        list<list<V>> res;        scc(*g, res);        for (list<V> c : res) {            c.sort();            for (V v : c) cout << v << " ";            cout << endl;        }    }    else if (a == "prim") {        Pred<V> res;        prim(*(WeightedGraph<V>*)g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            cout << endl;        }    }    else if (a == "bell") {        SP<V> res;        if (bellmanFord(*(WeightedGraph<V>*)g, s, res)) {            for (V v : g->vertices()) {                path(s, v, res);                cout << " " << res.dist[v] << endl;            }        }        else {            cout << "negative cycle" << endl;        }    }    else if (a == "dijk") {        SP<V> res;        dijkstra(*(WeightedGraph<V>*)g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            cout << " " << res.dist[v] << endl;        }    }    else {        cout << "unknown algorithm: " << a << endl;    }}
\ No newline at end of file
+#include <cmath>#include <cstdlib>#include <fstream>#include <iostream>#include <random>#include <set>#include <sstream>#include <string>#include <thread>#include <sys/wait.h>using namespace std;#include "graph.h"#include "csr.h"#include "server.h"#include "batch.h"#include "apsp.h"#include "johnson.h"#include "centrality.h"#include "components.h"#include "biconnected.h"#include "flow.h"#include "kpaths.h"#include "reach.h"#include "labeling.h"#include "dynamic.h"#include "incremental.h"#include "cache.h"#include "external.h"#include "partition.h"#include "distributed.h"#include "numa.h"#include "traversal.h"#include "pregel.h"#include "semiring.h"#include "widest.h"// Knotentyp.using V = string;// Feld mit Testgraphen.// (Für eigene Tests können beliebige weitere Graphen hinzugefügt werden.)// Damit Graphen der Typen Graph<V> und WeightedGraph<V> im selben Feld// gespeichert werden können, werden Zeiger auf den Basistyp Graph<V>// gespeichert, die bei Bedarf in Zeiger auf WeightedGraph<V>// umgewandelt werden.Graph<V>* graphs [] = {        // Beispiel eines ungewichteten Graphen.        new Graph<string>({ //Beispiel                                  { "A", { "B", "C" } },                                  { "B", { } },                                  { "C", { "D" } },                                  { "D", { "E" } },                                  { "E", {  } }                          }),        new Graph<string>({ //Aufgabe 9 b                                  { "A", { "B", "H" } },                                  { "B", {"C", "F"} },                                  { "C", { "D", "G" } },                                  { "D", { "E", "G", "H"} },                                  { "E", {  } },                                  { "F", { "A", "B", "G"} },                                  { "G", { "H" } },                                  { "H", { "C" } }                          }),        new Graph<string>({ //Aufgabe 9 a                                  { "A", { "A", "B" } },                                  { "B", {"A", "C", "D"} },                                  { "C", { "B", "D" } },                                  { "D", { "B"} },                                  { "E", { "D", "F" } },                                  { "F", { "E", "F"} }                                  }),        // Beispiel eines gewichteten Graphen.        new WeightedGraph<string>({ //Beispiel                                          { "A", { { "B", 2 }, { "C", 3 } } },                                          { "B", { } },                                          { "C", { { "C", 4 } } }                                  }),        new WeightedGraph<string>({ //Jonas Graph                                          { "A", { { "B", 3 }, { "E", 1 }, { "F", 5 } } },                                          { "B", { { "A", 3}, { "C",8}, { "D", 7 }, { "E", 2 }, { "F", 5 }} },                                          { "C", { { "B", 8 }, { "D", 5 }, { "E", 7 } } },                                          { "D", { { "B", 7 }, { "C", 5 }, { "E", 8 } } },                                          { "E", { { "A", 1 }, { "B", 2 }, { "C", 7 }, { "D", 8 }, { "F", 4 } } },                                          { "F", { { "A", 5 }, { "B", 5 }, { "E", 4 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 13 Djik                                          { "A", { { "B", 10 }, { "E", 5 } } },                                          { "B", { { "C", 1}, { "E",2} } },                                          { "C", { { "D", 4 } } },                                          { "D", { { "A", 7 }, { "C", 6 } } },                                          { "E", { { "B", 3 }, { "C", 9 }, { "D", 2 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 12 Bellman                                          { "A", { { "B", 6 }, { "E", 7 } } },                                          { "B", { { "C", 5}, { "D",-4}, { "E",8} } },                                          { "C", { { "B", -2 } } },                                          { "D", { { "A", 2 }, { "C", 7 } } },                                          { "E", {  { "C", -3 }, { "D", 9 } } },                                  }),        new WeightedGraph<string>({ //Aufgabe 11 Prim                                          { "A", { { "A", 10 }, { "B", 4 }, {"H", 8} } },                                          { "B", { { "A", 4}, { "C",8}, { "H",11} } },                                          { "C", { { "B", 8 }, {"D", 7}, {"F", 4}, {"I", 2} } },                                          { "D", { { "C", 7 }, { "E", 9 }, {"F", 14} } },                                          { "E", {  { "D", 9 }, { "F", 10 } } },                                          { "F", {  { "C", 4 }, { "D", 14 }, {"G", 2} } },                                          { "G", {  { "F", 2 }, {"H", 1}, { "I", 6 } } },                                          { "H", {  {"A", 8}, {"B", 11}, { "G", 1 }, { "I", 7 } } },                                          { "I", {  { "C", 2 }, { "G", 6 }, {"H", 7} } },                                  }),        new WeightedGraph<string>({ //Aufgabe 12 Bellman mit cylce                                          { "A", { { "B", 1 }, { "C", 1 } } },                                          { "B", { { "C", -1} } },                                          { "C", { { "B", -1 } } }                                  }),};// Weg vom Startknoten s zum Knoten v anhand der Vorgängerinformation// in res ausgeben.void path (V s, V v, Pred<V>& res) {    if (s != v && res.pred[v] != res.NIL) {        path(s, res.pred[v], res);        cout << " -> ";    }    cout << v;}// Gewichteten Graphen mit Knoten des Typs uint aus der Datei name lesen// (für den Abfrageserver).// Jede nichtleere Zeile enthält eine Kante "u v [w]"; ein fehlendes// Gewicht bedeutet 1. Zeilen, die mit # beginnen, werden ignoriert.WeightedGraph<uint> readGraph (const char* name) {    map<uint, list<pair<uint, double>>> a;    ifstream in(name);    if (!in) throw runtime_error(string("Datei nicht lesbar: ") + name);    string line;    while (getline(in, line)) {        if (line.empty() || line[0] == '#') continue;        istringstream ls(line);        uint u, v;        double w = 1;        if (!(ls >> u >> v)) continue;        ls >> w;        a[u].push_back({ v, w });        a[v];    }    return WeightedGraph<uint>(a);}// Art einer Anfrage an den Server aus ihrem Namen ermitteln// (0 bei unbekanntem Namen).uint32_t opCode (const string& op) {    if (op == "sp") return OP_SP;    if (op == "bfs") return OP_BFS;    if (op == "reach") return OP_REACH;    return 0;}/* *  Prüfungen (Modus check) */// Die Prüfungen vergleichen die Algorithmen auf eingefrorenen Graphen// mit den Referenzimplementierungen aus graph.h bzw. csr.h, und zwar// auf allen Testgraphen aus graphs sowie einem größeren Zufallsgraphen,// auf dem auch die parallelen Teile mit mehreren Threads laufen.// Anzahl der Testgraphen und Index des ersten gewichteten Graphen.const uint GRAPHS = sizeof(graphs) / sizeof(graphs[0]);const uint WEIGHTED = 3;// Größe, bis zu der Referenzwerte mit graph.h berechnet werden// (bei größeren Graphen mit csr.h) und alle Knoten als Start- und// Zielknoten geprüft werden.const uint SMALL = 100;// Anzahl der fehlgeschlagenen Prüfungen.uint failures = 0;// Bedingung ok einer Prüfung auswerten (what beschreibt sie).void expect (bool ok, const string& what) {    if (!ok) {        failures++;        cout << "failed: " << what << endl;    }}// Zufälligen gewichteten Graphen mit n Knoten ("0" bis "n-1") und m// Kanten mit Gewichten von 1 bis 20 erzeugen.WeightedGraph<V> randomGraph (uint n, uint m, uint seed) {    mt19937 rng(seed);    map<V, list<pair<V, double>>> a;    for (uint v = 0; v < n; v++) a[to_string(v)];    for (uint i = 0; i < m; i++) {        uint u = rng() % n, v = rng() % n;        a[to_string(u)].push_back({ to_string(v), double(1 + rng() % 20) });    }    return WeightedGraph<V>(a);}// Alle Testgraphen eingefroren.vector<FrozenGraph<V>> testGraphs () {    vector<FrozenGraph<V>> gs;    for (uint i = 0; i < GRAPHS; i++) {        if (i < WEIGHTED) gs.push_back(freeze(*graphs[i]));        else gs.push_back(freeze(*(WeightedGraph<V>*)graphs[i]));    }    return gs;}// Alle Testgraphen eingefroren, gefolgt von einem Zufallsgraphen mit// n Knoten und 4 n Kanten.vector<FrozenGraph<V>> checkGraphs (uint n = 3000) {    vector<FrozenGraph<V>> gs = testGraphs();    WeightedGraph<V> r = randomGraph(n, 4 * n, 1);    gs.push_back(freeze(r));    return gs;}// Eingefrorenen Graphen g wieder als WeightedGraph darstellen// (für die Referenzimplementierungen aus graph.h).WeightedGraph<V> thaw (const FrozenGraph<V>& g) {    map<V, list<pair<V, double>>> a;    for (uint u = 0; u < g.size(); u++) {        a[g.vs[u]];        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {            a[g.vs[u]].push_back({ g.vs[g.tgt[e]], g.weight(e) });        }    }    return WeightedGraph<V>(a);}// Ungerichtete Version des Graphen g: jede Kante in beiden Richtungen// mit dem kleinsten Gewicht aller Kanten zwischen den beiden Knoten,// ohne Schleifen und parallele Kanten.FrozenGraph<V> symmetric (const FrozenGraph<V>& g) {    map<pair<V, V>, double> w;    for (uint u = 0; u < g.size(); u++) {        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {            V a = g.vs[u], b = g.vs[g.tgt[e]];            if (a == b) continue;            if (b < a) swap(a, b);            auto it = w.find({ a, b });            if (it == w.end() || g.weight(e) < it->second) w[{ a, b }] = g.weight(e);        }    }    map<V, list<pair<V, double>>> adj;    for (V v : g.vs) adj[v];    for (auto& x : w) {        adj[x.first.first].push_back({ x.first.second, x.second });        adj[x.first.second].push_back({ x.first.first, x.second });    }    WeightedGraph<V> s(adj);    return freeze(s);}// Zerlegung der Knoten (Indizes) nach gleicher Marke labels[v].set<set<uint>> classes (const vector<uint>& labels) {    map<uint, set<uint>> m;    for (uint v = 0; v < labels.size(); v++) m[labels[v]].insert(v);    set<set<uint>> res;    for (auto& x : m) res.insert(x.second);    return res;}// Starke Zusammenhangskomponenten des Graphen g als Zerlegung der// Knotenindizes nach scc aus graph.h.// (scc aus graph.h kopiert den Graphen vielfach; nur für Graphen mit// einigen hundert Knoten geeignet.)set<set<uint>> sccReference (const FrozenGraph<V>& g) {    list<list<V>> comps;    scc(thaw(g), comps);    set<set<uint>> res;    for (auto& c : comps) {        set<uint> s;        for (auto& v : c) s.insert(g.index(v));        res.insert(s);    }    return res;}// Hat der Graph g negative Kantengewichte?bool negative (const FrozenGraph<V>& g) {    for (double w : g.wt) {        if (w < 0) return true;    }    return false;}// Stimmen die Distanzen a und b bis auf Rundungsfehler überein?bool near (double a, double b) {    return a == b || fabs(a - b) <= 1e-9 * max(fabs(a), fabs(b));}bool near (const vector<double>& a, const vector<double>& b) {    if (a.size() != b.size()) return false;    for (size_t i = 0; i < a.size(); i++) {        if (!near(a[i], b[i])) return false;    }    return true;}// Länge des Weges p (Indizes) im Graphen g (bei parallelen Kanten über// die leichteste); NaN, wenn eine Kante des Weges fehlt.double length (const FrozenGraph<V>& g, const vector<uint>& p) {    double len = 0;    for (size_t i = 0; i + 1 < p.size(); i++) {        double w = numeric_limits<double>::quiet_NaN();        for (uint e = g.off[p[i]]; e < g.off[p[i] + 1]; e++) {            if (g.tgt[e] == p[i + 1] && !(g.weight(e) >= w)) w = g.weight(e);        }        len += w;    }    return len;}// Zu prüfende Start- bzw. Zielknoten (Indizes): alle Knoten eines// kleinen Graphen, sonst etwa 50 gleichmäßig verteilte.vector<uint> sample (const FrozenGraph<V>& g) {    vector<uint> vs;    uint step = g.size() <= SMALL ? 1 : g.size() / 50;    for (uint v = 0; v < g.size(); v += step) vs.push_back(v);    return vs;}// Referenzdistanzen vom Knoten s (Index) zu allen Knoten in d// speichern: bellmanFord aus graph.h bei kleinen Graphen, sonst// dijkstra aus csr.h (größere Graphen haben keine negativen Gewichte).// Resultatwert false bei einem negativen Zyklus.bool distances (const FrozenGraph<V>& g, uint s, vector<double>& d) {    d.assign(g.size(), numeric_limits<double>::infinity());    if (g.size() <= SMALL) {        SP<V> res;        if (!bellmanFord(thaw(g), g.vs[s], res)) return false;        for (uint v = 0; v < g.size(); v++) d[v] = res.dist[g.vs[v]];        return true;    }    Workspace ws;    dijkstra(g, s, ws);    for (uint v = 0; v < g.size(); v++) d[v] = ws.distance(v);    return true;}// Referenzebenen (Anzahl der Kanten) vom Knoten s (Index) aus in d// speichern (NONE, wenn nicht erreichbar): bfs aus graph.h bei kleinen// Graphen, sonst aus csr.h.void levels (const FrozenGraph<V>& g, uint s, vector<uint>& d) {    d.assign(g.size(), NONE);    if (g.size() <= SMALL) {        BFS<V> res;        bfs(thaw(g), g.vs[s], res);        for (uint v = 0; v < g.size(); v++) d[v] = res.dist[g.vs[v]];        return;    }    Workspace ws;    bfs(g, s, ws);    for (uint v = 0; v < g.size(); v++) {        if (ws.seen(v)) d[v] = uint(ws.dist[v]);    }}// Graphen g mit den Indizes als Knoten darstellen (für den// Abfrageserver).FrozenGraph<uint> numbered (const FrozenGraph<V>& g) {    FrozenGraph<uint> f;    for (uint v = 0; v < g.size(); v++) {        f.vs.push_back(v);        f.idx[v] = v;    }    f.off = g.off;    f.tgt = g.tgt;    f.wt = g.wt;    return f;}// Abfrageserver: answer mit und ohne Zwischenspeicher gegen die// Referenzdistanzen und -ebenen.void checkServer () {    for (auto& g0 : checkGraphs()) {        FrozenGraph<uint> g = numbered(g0);        TreeCache cache(1 << 20);        Workspace ws;        vector<uint32_t> p;        for (uint s : sample(g0)) {            vector<double> d;            vector<uint> l;            bool sp = !negative(g0) && distances(g0, s, d);            levels(g0, s, l);            for (uint t : sample(g0)) {                for (TreeCache* c : { (TreeCache*) nullptr, &cache }) {                    Response r = answer(g, { OP_BFS, s, t }, ws, p, c);                    expect(l[t] == NONE ? r.status == ST_UNREACHABLE                                        : r.status == ST_OK && r.dist == l[t]                                          && p.size() == l[t] + 1                                          && p.front() == s && p.back() == t,                           "server bfs");                    if (!sp) continue;                    r = answer(g, { OP_SP, s, t }, ws, p, c);                    expect(d[t] == numeric_limits<double>::infinity()                           ? r.status == ST_UNREACHABLE                           : r.status == ST_OK && r.dist == d[t]                             && p.front() == s && p.back() == t,                           "server sp");                }            }        }    }    // serve mit einem einzigen Arbeitsthread in einem eigenen Prozess:    // Eine untätige Verbindung darf die Anfragen einer zweiten nicht    // aufhalten, und beide werden wie von answer beantwortet.    FrozenGraph<V> g0 = checkGraphs().back();    FrozenGraph<uint> g = numbered(g0);    string path = "/tmp/Algo_U3-check-" + to_string(getpid()) + ".sock";    pid_t pid = fork();    if (pid == 0) {        serve(g, path.c_str(), 1, 1 << 20);        _exit(1);    }    int idle = -1, busy = -1;    for (uint i = 0; i < 500 && idle < 0; i++) {        idle = connectServer(path.c_str());        if (idle < 0) this_thread::sleep_for(chrono::milliseconds(10));    }    busy = connectServer(path.c_str());    expect(idle >= 0 && busy >= 0, "server Verbindung");    if (idle >= 0 && busy >= 0) {        // Hängt der Server, schlägt die erste Anfrage nach 5 s fehl und        // es werden keine weiteren mehr gestellt.        timeval limit = { 5, 0 };        for (int fd : { idle, busy }) {            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));        }        Workspace ws;        vector<uint32_t> p, q;        bool ok = true;        for (uint s : sample(g0)) {            for (uint t : sample(g0)) {                for (uint32_t op : { OP_SP, OP_BFS, OP_REACH }) {                    Request req = { op, s, t };                    Response r, ref = answer(g, req, ws, p);                    ok = ok && query(busy, req, r, q) && r.status == ref.status                         && (r.status != ST_OK || r.dist == ref.dist) && q == p;                }            }        }        Response r;        ok = ok && query(idle, { OP_REACH, 0, 0 }, r, p) && r.status == ST_OK;        expect(ok, "server Anfragen");    }    close(idle);    close(busy);    kill(pid, SIGKILL);    waitpid(pid, nullptr, 0);    unlink(path.c_str());}// Viele Suchen parallel: bfsMany und dijkstraMany (nur ohne negative// Gewichte) mit 4 Threads gegen die Referenzebenen und -distanzen.void checkBatch () {    ThreadPool pool(4);    for (auto& g : checkGraphs()) {        vector<uint> sources = sample(g);        vector<vector<double>> dist(sources.size());        vector<vector<uint>> lev(sources.size());        bfsMany(g, sources, [&] (size_t k, const Workspace& ws) {            lev[k].assign(g.size(), NONE);            for (uint v = 0; v < g.size(); v++) {                if (ws.seen(v)) lev[k][v] = uint(ws.dist[v]);            }        }, pool);        if (!negative(g)) {            dijkstraMany(g, sources, [&] (size_t k, const Workspace& ws) {                dist[k].resize(g.size());                for (uint v = 0; v < g.size(); v++) dist[k][v] = ws.distance(v);            }, pool);        }        for (size_t k = 0; k < sources.size(); k++) {            vector<double> d;            vector<uint> l;            levels(g, sources[k], l);            expect(lev[k] == l, "bfsMany");            if (negative(g) || !distances(g, sources[k], d)) continue;            expect(dist[k] == d, "dijkstraMany");        }    }}// Kürzeste Wege zwischen allen Paaren: apsp mit und ohne Vorgänger// gegen die Referenzdistanzen; Wege aus den Vorgängern müssen die// Distanz als Länge haben. Bei einem negativen Zyklus muss apsp false// liefern.void checkApsp () {    ThreadPool pool(4);    for (auto& g : checkGraphs(300)) {        DistMatrix m, plain;        bool ok = apsp(g, m, true, pool);        expect(apsp(g, plain, false, pool) == ok, "apsp ohne Vorgänger");        bool cycle = false;        vector<uint> p;        for (uint s : sample(g)) {            vector<double> d;            if (!distances(g, s, d)) {                cycle = true;                continue;            }            if (!ok) continue;            vector<double> row(m.dist.begin() + size_t(s) * m.stride,                               m.dist.begin() + size_t(s) * m.stride + g.size());            expect(near(row, d), "apsp Distanzen");            for (uint t = 0; t < g.size(); t++) {                expect(plain.distance(s, t) == m.distance(s, t), "apsp ohne Vorgänger");                m.path(s, t, p);                expect(d[t] == numeric_limits<double>::infinity()                       ? p.empty() : near(length(g, p), d[t]), "apsp Weg");            }        }        expect(ok != cycle, "apsp negativer Zyklus");    }}// Johnson gegen apsp, auch auf dem Zufallsgraphen mit durch Potentiale// verschobenen (teils negativen) Gewichten ohne negativen Zyklus.void checkJohnson () {    ThreadPool pool(4);    vector<FrozenGraph<V>> gs = checkGraphs(300);    FrozenGraph<V> shifted = gs.back();    mt19937 rng(2);    vector<double> h(shifted.size());    for (double& x : h) x = double(rng() % 30);    for (uint u = 0; u < shifted.size(); u++) {        for (uint e = shifted.off[u]; e < shifted.off[u + 1]; e++) {            shifted.wt[e] += h[u] - h[shifted.tgt[e]];        }    }    expect(negative(shifted), "johnson Testgraph ohne negative Gewichte");    gs.push_back(shifted);    for (auto& g : gs) {        DistMatrix a, j;        bool ok = apsp(g, a, false, pool);        expect(johnson(g, j, true, pool) == ok, "johnson negativer Zyklus");        if (!ok) continue;        vector<uint> p;        for (uint s = 0; s < g.size(); s++) {            for (uint t = 0; t < g.size(); t++) {                expect(near(j.distance(s, t), a.distance(s, t)), "johnson Distanzen");                j.path(s, t, p);                expect(j.distance(s, t) == numeric_limits<double>::infinity()                       ? p.empty() : near(length(g, p), j.distance(s, t)),                       "johnson Weg");            }        }    }}// Betweenness (exakt) gegen die Definition auf Graphen mit positiven// Gewichten: sigma(s, t) zählt die kürzesten Wege über die// Referenzdistanzen, und v erhält für jedes Paar (s, t) den Anteil// sigma(s, v) sigma(v, t) / sigma(s, t).void checkBetweenness () {    const double inf = numeric_limits<double>::infinity();    ThreadPool pool(4);    for (auto& g : checkGraphs(120)) {        uint n = g.size();        bool positive = true;        for (uint e = 0; e < g.edges(); e++) positive = positive && g.weight(e) > 0;        if (!positive) continue;        vector<vector<double>> d(n), sigma(n, vector<double>(n, 0));        for (uint s = 0; s < n; s++) {            distances(g, s, d[s]);            vector<uint> order;            for (uint v = 0; v < n; v++) order.push_back(v);            sort(order.begin(), order.end(),                 [&] (uint a, uint b) { return d[s][a] < d[s][b]; });            sigma[s][s] = 1;            for (uint v : order) {                if (v == s || d[s][v] == inf) continue;                for (uint u = 0; u < n; u++) {                    for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                        if (g.tgt[e] == v && near(d[s][u] + g.weight(e), d[s][v])) {                            sigma[s][v] += sigma[s][u];                        }                    }                }            }        }        vector<double> ref(n, 0), out;        for (uint s = 0; s < n; s++) {            for (uint t = 0; t < n; t++) {                if (s == t || d[s][t] == inf) continue;                for (uint v = 0; v < n; v++) {                    if (v != s && v != t && near(d[s][v] + d[v][t], d[s][t])) {                        ref[v] += sigma[s][v] * sigma[v][t] / sigma[s][t];                    }                }            }        }        betweenness(g, out, 0, 1, pool);        for (uint v = 0; v < n; v++) {            expect(fabs(out[v] - ref[v]) <= 1e-9 * (1 + ref[v]), "betweenness");        }    }}// Einfache sequenzielle Potenziteration für PageRank über die Kanten// von g (Rang der Knoten ohne Nachfolger wie die Teleportation tele// verteilt).vector<double> pagerankPlain (const FrozenGraph<V>& g, const vector<double>& tele,                              uint iterations, double d) {    uint n = g.size();    vector<double> rank(tele), next(n);    for (uint i = 0; i < iterations; i++) {        double dm = 0;        for (uint u = 0; u < n; u++) {            if (g.off[u] == g.off[u + 1]) dm += rank[u];        }        for (uint v = 0; v < n; v++) next[v] = (1 - d + d * dm) * tele[v];        for (uint u = 0; u < n; u++) {            uint deg = g.off[u + 1] - g.off[u];            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                next[g.tgt[e]] += d * rank[u] / deg;            }        }        rank.swap(next);    }    return rank;}// PageRank (double und float, mit und ohne Teleportationsmenge mit// mehrfachem Knoten) gegen die einfache Potenziteration.void checkPageRank () {    ThreadPool pool(4);    for (auto& g : checkGraphs()) {        uint n = g.size();        for (bool personal : { false, true }) {            PageRank<double> res;            PageRank<float> low;            res.maxIter = low.maxIter = 30;            res.tolerance = low.tolerance = 0;            vector<double> tele(n, 1.0 / n);            if (personal) {                res.teleport = low.teleport = { 0, 0, n - 1 };                tele.assign(n, 0);                tele[0] += 2.0 / 3;                tele[n - 1] += 1.0 / 3;            }            pagerank(g, res, pool);            pagerank(g, low, pool);            vector<double> ref = pagerankPlain(g, tele, 30, res.damping);            double sum = 0;            for (uint v = 0; v < n; v++) {                sum += res.rank[v];                expect(fabs(res.rank[v] - ref[v]) <= 1e-12, "pagerank");                expect(fabs(low.rank[v] - ref[v]) <= 1e-5, "pagerank float");            }            expect(res.iterations == 30 && fabs(sum - 1) <= 1e-9, "pagerank Summe");        }    }}// Zusammenhangskomponenten: scc (Tarjan) und cc (Afforest, mit// verschiedenen Rundenzahlen und 4 Threads) gegen scc aus graph.h auf g// bzw. auf der ungerichteten Version von g.void checkComponents () {    ThreadPool pool(4);    for (auto& g : checkGraphs(300)) {        vector<uint> comp;        uint count = scc(g, comp);        set<set<uint>> ref = sccReference(g);        expect(count == ref.size() && classes(comp) == ref, "scc");        for (uint u = 0; u < g.size(); u++) {            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                expect(comp[u] >= comp[g.tgt[e]], "scc Reihenfolge");            }        }        FrozenGraph<V> s = symmetric(g);        ref = sccReference(s);        for (uint rounds : { 0, 1, 2, 5 }) {            vector<uint> labels;            count = cc(s, labels, pool, rounds);            expect(count == ref.size() && classes(labels) == ref, "cc");            for (auto& c : ref) {                for (uint v : c) expect(labels[v] == *c.begin(), "cc Marken");            }        }    }}// Anzahl der Zusammenhangskomponenten des ungerichteten Graphen s ohne// den Knoten x und ohne die Kante zwischen a und b (Indizes, jeweils// NONE für keinen).uint pieces (const FrozenGraph<V>& s, uint x, uint a, uint b) {    UnionFind uf(s.size());    uint count = s.size() - (x != NONE);    for (uint u = 0; u < s.size(); u++) {        for (uint e = s.off[u]; e < s.off[u + 1]; e++) {            uint v = s.tgt[e];            if (u == x || v == x || (u == a && v == b) || (u == b && v == a)) continue;            if (uf.unite(u, v)) count--;        }    }    return count;}// Artikulationspunkte und Brücken gegen Entfernen jedes Knotens bzw.// jeder Kante; die Komponenten müssen die Kanten zerlegen, sich genau// in den Artikulationspunkten berühren und jede Brücke allein// enthalten. Geprüft wird auf den ungerichteten Versionen der// Testgraphen und eines dünnen Zufallsgraphen.void checkBiconnected () {    vector<FrozenGraph<V>> gs = checkGraphs(120);    WeightedGraph<V> sparse = randomGraph(200, 220, 3);    gs.push_back(freeze(sparse));    for (auto& g : gs) {        FrozenGraph<V> s = symmetric(g);        BCC<V> res;        biconnected(thaw(s), res);        uint base = pieces(s, NONE, NONE, NONE);        set<uint> cuts, cutsRef;        for (auto& v : res.articulation) cuts.insert(s.index(v));        for (uint v = 0; v < s.size(); v++) {            if (pieces(s, v, NONE, NONE) > base) cutsRef.insert(v);        }        expect(cuts == cutsRef && cuts.size() == res.articulation.size(),               "biconnected Artikulationspunkte");        set<pair<uint, uint>> bridges, bridgesRef, edges;        for (auto& e : res.bridges) {            uint a = s.index(e.first), b = s.index(e.second);            bridges.insert({ min(a, b), max(a, b) });        }        for (uint u = 0; u < s.size(); u++) {            for (uint e = s.off[u]; e < s.off[u + 1]; e++) {                uint v = s.tgt[e];                if (u < v && pieces(s, NONE, u, v) > base) bridgesRef.insert({ u, v });            }        }        expect(bridges == bridgesRef && bridges.size() == res.bridges.size(),               "biconnected Brücken");        size_t count = 0;        map<uint, uint> member;        for (auto& c : res.components) {            set<uint> vs;            for (auto& e : c) {                uint a = s.index(e.first), b = s.index(e.second);                edges.insert({ min(a, b), max(a, b) });                vs.insert(a);                vs.insert(b);            }            for (uint v : vs) member[v]++;            count += c.size();            if (c.size() == 1) {                uint a = s.index(c.front().first), b = s.index(c.front().second);                bridgesRef.erase({ min(a, b), max(a, b) });            }        }        expect(count == s.edges() / 2 && edges.size() == count,               "biconnected Kanten der Komponenten");        expect(bridgesRef.empty(), "biconnected Brücke als Komponente");        for (auto& m : member) {            expect((m.second > 1) == (cuts.count(m.first) > 0),                   "biconnected Berührpunkte");        }    }}// Ist res ein gültiger Fluss von s nach t (s != t) im Graphen g mit dem// Wert res.value, und hat der Schnitt res.cut die Kapazität// res.value?bool validFlow (const FrozenGraph<V>& g, uint s, uint t, const MaxFlow& res) {    vector<double> net(g.size(), 0);    double cut = 0;    for (uint u = 0; u < g.size(); u++) {        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {            uint v = g.tgt[e];            if (res.flow[e] < 0 || res.flow[e] > g.weight(e)) return false;            net[u] -= res.flow[e];            net[v] += res.flow[e];            if (res.cut[u] && !res.cut[v]) cut += g.weight(e);        }    }    for (uint v = 0; v < g.size(); v++) {        if (v != s && v != t && fabs(net[v]) > 1e-9 * (1 + res.value)) return false;    }    return res.cut[s] && !res.cut[t] && near(-net[s], res.value)           && near(cut, res.value);}// Maximaler Fluss: pushRelabel und dinic müssen denselben Wert liefern,// gültige Flüsse und Schnitte mit diesem Wert ergeben und für s == t// den leeren Fluss liefern (Graphen ohne negative Gewichte).void checkFlow () {    for (auto& g : checkGraphs(300)) {        if (negative(g)) continue;        for (uint s : sample(g)) {            for (uint t : sample(g)) {                MaxFlow a, b;                pushRelabel(g, s, t, a);                dinic(g, s, t, b);                if (s == t) {                    for (MaxFlow* r : { &a, &b }) {                        expect(r->value == 0 && r->cut.empty()                               && r->flow == vector<double>(g.edges(), 0),                               "flow s == t");                    }                    continue;                }                expect(near(a.value, b.value), "pushRelabel gegen dinic");                expect(validFlow(g, s, t, a), "pushRelabel Fluss");                expect(validFlow(g, s, t, b), "dinic Fluss");            }        }        // maxFlow auf dem gewichteten Graphen liefert dasselbe wie        // pushRelabel bzw. dinic, aber nach Knotenwerten.        WeightedGraph<V> w = thaw(g);        vector<uint> ends = sample(g);        ends.resize(min(ends.size(), size_t(5)));        for (uint s : ends) {            for (uint t : ends) {                for (bool useDinic : { false, true }) {                    MaxFlow a;                    if (useDinic) dinic(g, s, t, a);                    else pushRelabel(g, s, t, a);                    Flow<V> r;                    maxFlow(w, g.vs[s], g.vs[t], r, useDinic);                    // (Parallele Kanten werden zusammengefasst.)                    map<pair<V, V>, double> flow;                    set<V> cut;                    for (uint u = 0; u < g.size(); u++) {                        if (s != t && a.cut[u]) cut.insert(g.vs[u]);                        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                            flow[{ g.vs[u], g.vs[g.tgt[e]] }] += a.flow[e];                        }                    }                    expect(r.value == a.value && r.flow == flow && r.cut == cut,                           "maxFlow");                }            }        }        Flow<V> r;        maxFlow(w, g.vs[0], V("?"), r);        expect(r.value == 0 && r.cut.empty(), "maxFlow unbekannter Knoten");    }}// Längen aller schleifenfreien Wege vom Knoten u zum Knoten t im Graphen// g durch vollständige Aufzählung an costs anhängen (on markiert die// Knoten des bisherigen Weges der Länge len).void simplePaths (const FrozenGraph<V>& g, uint u, uint t, double len,                  vector<bool>& on, vector<double>& costs) {    if (u == t) {        costs.push_back(len);        return;    }    on[u] = true;    for (uint e = g.off[u]; e < g.off[u + 1]; e++) {        if (!on[g.tgt[e]]) simplePaths(g, g.tgt[e], t, len + g.weight(e), on, costs);    }    on[u] = false;}// k kürzeste Wege gegen die Aufzählung aller schleifenfreien Wege auf// den Testgraphen und einem kleinen ungerichteten Zufallsgraphen (ohne// negative Gewichte); jeder Weg muss zu seinen Kanten und seiner Länge// passen und darf keinen Knoten wiederholen.void checkKPaths () {    vector<FrozenGraph<V>> gs = testGraphs();    WeightedGraph<V> r = randomGraph(10, 15, 4);    gs.push_back(symmetric(freeze(r)));    for (auto& g : gs) {        if (negative(g)) continue;        for (uint s = 0; s < g.size(); s++) {            for (uint t = 0; t < g.size(); t++) {                vector<double> costs;                vector<bool> on(g.size(), false);                simplePaths(g, s, t, 0, on, costs);                sort(costs.begin(), costs.end());                vector<Path> res;                kShortestPaths(g, s, t, 5, res);                expect(res.size() == min(costs.size(), size_t(5)), "kpaths Anzahl");                for (size_t i = 0; i < res.size() && i < costs.size(); i++) {                    const Path& p = res[i];                    expect(near(p.cost, costs[i]), "kpaths Länge");                    expect(near(length(g, p.vs), p.cost), "kpaths Weg");                    expect(p.vs.front() == s && p.vs.back() == t                           && p.es.size() + 1 == p.vs.size()                           && set<uint>(p.vs.begin(), p.vs.end()).size() == p.vs.size(),                           "kpaths Knoten");                    for (size_t j = 0; j < p.es.size(); j++) {                        uint e = p.es[j];                        expect(g.off[p.vs[j]] <= e && e < g.off[p.vs[j] + 1]                               && g.tgt[e] == p.vs[j + 1], "kpaths Kanten");                    }                }            }        }    }}// Erreichbarkeitsindex (dicht sowie komprimiert mit kleinen Stücken)// gegen die Breitensuche, auch auf einem dünnen Zufallsgraphen mit// vielen kleinen Komponenten.void checkReach () {    ThreadPool pool(4);    vector<FrozenGraph<V>> gs = checkGraphs();    WeightedGraph<V> sparse = randomGraph(2000, 2400, 5);    gs.push_back(freeze(sparse));    for (auto& g : gs) {        ReachIndex dense, packed;        buildReach(g, dense, pool);        buildReach(g, packed, pool, 0, 1);        for (uint s : sample(g)) {            vector<uint> l;            levels(g, s, l);            for (uint t = 0; t < g.size(); t++) {                expect(dense.reachable(s, t) == (l[t] != NONE), "reach dicht");                expect(packed.reachable(s, t) == (l[t] != NONE), "reach komprimiert");            }        }    }}// Distanzindex (gerichtet sowie ungerichtet auf der ungerichteten// Version) gegen apsp, auch nach Speichern und Laden; eine gekürzte// Datei darf nicht geladen werden.void checkLabeling () {    const char* file = "check.labels";    for (auto& g0 : checkGraphs(300)) {        if (negative(g0)) continue;        for (bool undirected : { false, true }) {            FrozenGraph<V> g = undirected ? symmetric(g0) : g0;            DistMatrix m;            apsp(g, m, false);            Labeling idx, loaded;            buildLabeling(g, idx, undirected);            expect(idx.save(file) && loaded.load(file), "labeling speichern und laden");            for (uint s = 0; s < g.size(); s++) {                for (uint t = 0; t < g.size(); t++) {                    expect(near(idx.distance(s, t), m.distance(s, t)), "labeling");                    expect(loaded.distance(s, t) == idx.distance(s, t), "labeling geladen");                }            }        }    }    // Datei um das letzte Byte kürzen.    ifstream in(file, ios::binary);    string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());    in.close();    ofstream(file, ios::binary).write(data.data(), data.size() - 1);    Labeling broken;    expect(!broken.load(file), "labeling gekürzte Datei");    remove(file);}// Kanten (u, v) mit Gewicht des eingefrorenen Graphen g nach Knoten.map<pair<V, V>, double> edgeMap (const FrozenGraph<V>& g) {    map<pair<V, V>, double> m;    for (uint u = 0; u < g.size(); u++) {        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {            m[{ g.vs[u], g.vs[g.tgt[e]] }] = g.weight(e);        }    }    return m;}// Dynamischer Graph: zufällige Stapel von Einfügungen (auch mit neuen// Knoten), Löschungen und Gewichtsänderungen gegen eine Kantentabelle;// jeder Schnappschuss muss genau die Kanten der Tabelle enthalten.void checkDynamic () {    mt19937 rng(6);    vector<FrozenGraph<V>> gs = testGraphs();    gs.erase(gs.begin(), gs.begin() + WEIGHTED);    map<V, list<pair<V, double>>> a;    for (uint i = 0; i < 300; i++) {        for (uint v = rng() % 300, k = 0; k < 3; k++, v = (v + 1 + rng() % 20) % 300) {            a[to_string(i)].push_back({ to_string(v), double(1 + rng() % 20) });        }        // Einige Nachfolger doppelt (DynamicGraph übernimmt sie einmal).        if (i % 7 == 0) a[to_string(i)].push_back(a[to_string(i)].back());    }    WeightedGraph<V> r(a);    gs.push_back(freeze(r));    for (auto& g : gs) {        WeightedGraph<V> w = thaw(g);        DynamicGraph<V> d(w);        map<pair<V, V>, double> model = edgeMap(g);        set<V> vs(g.vs.begin(), g.vs.end());        vector<V> names(g.vs.begin(), g.vs.end());        for (uint i = 0; i < 10; i++) names.push_back("x" + to_string(i));        auto name = [&] { return names[rng() % names.size()]; };        for (uint round = 0; round < 20; round++) {            uint64_t version = d.version;            vector<DynamicGraph<V>::Edge> ins, upd;            vector<pair<V, V>> del;            for (uint i = 0; i < 30; i++) ins.push_back({ name(), name(), double(rng() % 20) });            for (uint i = 0; i < 20; i++) del.push_back({ name(), name() });            for (auto& e : model) {                if (rng() % 4 == 0) del.push_back(e.first);                else if (rng() % 4 == 0) upd.push_back({ e.first.first, e.first.second, double(rng() % 20) });            }            for (uint i = 0; i < 10; i++) upd.push_back({ name(), name(), 1 });            d.insertEdges(ins);            for (auto& e : ins) {                model[{ e.u, e.v }] = e.w;                vs.insert(e.u);                vs.insert(e.v);            }            d.removeEdges(del);            for (auto& e : del) model.erase(e);            d.updateWeights(upd);            for (auto& e : upd) {                auto it = model.find({ e.u, e.v });                if (it != model.end()) it->second = e.w;            }            FrozenGraph<V> f = d.snapshot();            expect(d.version > version, "dynamic version");            expect(set<V>(f.vs.begin(), f.vs.end()) == vs && f.vs.size() == vs.size(),                   "dynamic Knoten");            expect(edgeMap(f) == model && f.edges() == model.size() && d.edges() == model.size(),                   "dynamic Kanten");            for (uint i = 0; i < 20; i++) {                V u = name(), v = name();                auto it = model.find({ u, v });                expect(d.weight(u, v) == (it == model.end()                       ? numeric_limits<double>::infinity() : it->second),                       "dynamic Gewicht");            }        }    }}// Inkrementelle kürzeste Wege: nach jedem Stapel zufälliger// Gewichtsänderungen (auch auf Baumkanten) gegen die Referenzdistanzen// des geänderten Graphen; res muss dieselben Distanzen und zu ihnen// passende Vorgänger enthalten (gewichtete Graphen ohne negative// Gewichte).void checkIncremental () {    mt19937 rng(7);    for (auto& g0 : checkGraphs()) {        if (!g0.weighted() || negative(g0)) continue;        vector<uint> sources = sample(g0);        sources.resize(min(sources.size(), size_t(4)));        for (uint s : sources) {            FrozenGraph<V> g = g0;            DynamicSSSP<V> d(g, g.vs[s]);            SP<V> res;            for (uint v = 0; v < g.size(); v++) {                res.dist[g.vs[v]] = d.dist[v];                res.pred[g.vs[v]] = d.pred[v] == NONE ? res.NIL : g.vs[d.pred[v]];            }            for (uint round = 0; round < 10; round++) {                vector<DynamicSSSP<V>::Change> cs;                for (uint i = 0; i < 1 + g.edges() / 20; i++) {                    uint u = rng() % g.size();                    if (i % 2 && d.pred[u] != NONE) {                        cs.push_back({ g.vs[d.pred[u]], g.vs[u], double(1 + rng() % 40) });                    } else if (g.off[u] < g.off[u + 1]) {                        uint e = g.off[u] + rng() % (g.off[u + 1] - g.off[u]);                        cs.push_back({ g.vs[u], g.vs[g.tgt[e]], double(1 + rng() % 20) });                    }                }                for (auto& c : cs) {                    uint u = g.index(c.u), v = g.index(c.v);                    for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                        if (g.tgt[e] == v) g.wt[e] = c.w;                    }                }                d.update(cs, res);                vector<double> ref;                distances(g, s, ref);                expect(near(d.dist, ref), "incremental Distanzen");                for (uint v = 0; v < g.size(); v++) {                    V x = g.vs[v];                    expect(res.dist[x] == d.dist[v], "incremental res");                    if (v == s || ref[v] == numeric_limits<double>::infinity()) continue;                    uint p = g.index(res.pred[x]);                    expect(p != NONE && near(ref[p] + length(g, { p, v }), ref[v]),                           "incremental Vorgänger");                }            }        }    }}// Zwischenspeicher für Suchbäume: 4 Threads fragen zufällige Bäume bei// knappem Budget ab; jeder Baum muss die Referenzdistanzen bzw.// -ebenen liefern, das Budget muss eingehalten werden, und eine neue// Version muss alle Einträge verwerfen.void checkCache () {    vector<FrozenGraph<V>> gs = checkGraphs();    const FrozenGraph<V>& g = gs.back();    vector<uint> sources = sample(g);    vector<vector<double>> dist(sources.size());    vector<vector<uint>> lev(sources.size());    for (size_t k = 0; k < sources.size(); k++) {        distances(g, sources[k], dist[k]);        levels(g, sources[k], lev[k]);    }    Workspace probe;    bfs(g, 0, probe);    TreeCache cache(5 * PathTree(probe, g.size(), 0, true).bytes());    atomic<uint> wrong(0);    vector<thread> threads;    for (uint w = 0; w < 4; w++) {        threads.emplace_back([&, w] {            mt19937 rng(w);            Workspace ws;            for (uint i = 0; i < 500; i++) {                size_t k = rng() % sources.size();                bool hops = rng() % 2;                auto t = cache.tree(g, 1, sources[k], hops, ws);                for (uint v = 0; v < g.size(); v += 7) {                    bool ok = hops ? (lev[k][v] == NONE ? !t->reached(v)                                                        : t->distance(v) == lev[k][v])                                   : t->distance(v) == dist[k][v];                    if (!ok) wrong++;                }            }        });    }    for (auto& t : threads) t.join();    expect(wrong == 0, "cache Bäume");    expect(cache.used <= cache.budget && cache.hits + cache.misses == 2000           && cache.hits > 0, "cache Budget");    Workspace ws;    uint64_t misses = cache.misses;    cache.tree(g, 2, sources[0], false, ws);    expect(cache.misses == misses + 1 && cache.index.size() == 1, "cache Version");    // Eine ältere Version darf weder verwerfen noch aufnehmen noch die    // Bäume der neueren Version liefern.    auto t = cache.tree(g, 1, sources[0], false, ws);    expect(cache.version == 2 && cache.index.size() == 1           && cache.misses == misses + 2 && t->distance(sources[0]) == 0,           "cache alte Version");    cache.tree(g, 1, sources[1], true, ws);    expect(cache.version == 2 && cache.index.size() == 1, "cache alte Version");}// Semi-externe Verfahren über eine Kantendatei (mit winzigen und mit// großen Lesestücken): externalBfs gerichtet und ungerichtet gegen die// Breitensuche, externalCc gegen scc aus graph.h auf der ungerichteten// Version.void checkExternal () {    const char* file = "check.edges";    for (auto& g : checkGraphs(300)) {        FrozenGraph<V> s = symmetric(g);        expect(s.vs == g.vs, "external Knotenreihenfolge");        expect(writeEdges(g, file), "external schreiben");        for (size_t chunk : { size_t(7), size_t(1) << 20 }) {            EdgeStream es(chunk);            expect(es.open(file) && es.n == g.size() && es.m == g.edges(), "external öffnen");            for (uint x : sample(g)) {                for (bool undirected : { false, true }) {                    vector<uint> level, pred, ref;                    levels(undirected ? s : g, x, ref);                    expect(externalBfs(es, x, level, pred, undirected) > 0 && level == ref,                           "externalBfs");                    for (uint v = 0; v < g.size(); v++) {                        if (v == x || level[v] == NONE) continue;                        expect(pred[v] != NONE && level[pred[v]] + 1 == level[v],                               "externalBfs Vorgänger");                    }                }            }            vector<uint> labels;            set<set<uint>> ref = sccReference(s);            expect(externalCc(es, labels) == ref.size() && classes(labels) == ref,                   "externalCc");        }    }    remove(file);}// Zerlegung in k Teile: Schnittgröße und Balance, umnummerierter Graph// mit denselben Kanten und Ebenen wie g, Teilgraphen (auch nach// Schreiben und Lesen) mit genau den Kanten von g.void checkPartition () {    const string prefix = "check.part";    for (auto& g : checkGraphs()) {        for (uint k : { 2, 4, 7 }) {            vector<uint> part;            uint64_t cut = partition(g, k, part), ref = 0;            vector<uint> size(k, 0);            for (uint u = 0; u < g.size(); u++) {                expect(part[u] < k, "partition Teile");                size[part[u] % k]++;                for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                    if (part[u] != part[g.tgt[e]]) ref++;                }            }            expect(cut == ref, "partition Schnitt");            if (g.size() > SMALL) {                for (uint x : size) expect(x <= 1.03 * g.size() / k + 1, "partition Balance");                // Deutlich besser als eine zufällige Zuordnung.                expect(4 * cut < 3 * g.edges() * (k - 1) / k, "partition Qualität");            }            FrozenGraph<V> r = reorder(g, part);            expect(edgeMap(r) == edgeMap(g) && r.edges() == g.edges(), "reorder Kanten");            for (uint v = 1; v < r.size(); v++) {                expect(part[g.index(r.vs[v - 1])] <= part[g.index(r.vs[v])], "reorder Reihenfolge");            }            uint s = sample(g).back();            vector<uint> a, b;            levels(g, s, a);            levels(r, r.index(g.vs[s]), b);            for (uint v = 0; v < g.size(); v++) {                expect(a[v] == b[r.index(g.vs[v])], "reorder Ebenen");            }            vector<GraphPart> parts;            split(g, part, k, parts);            expect(writeParts(g, part, k, prefix), "writeParts");            multiset<pair<pair<uint, uint>, double>> edges, local;            for (uint u = 0; u < g.size(); u++) {                for (uint e = g.off[u]; e < g.off[u + 1]; e++) {                    edges.insert({ { u, g.tgt[e] }, g.weight(e) });                }            }            for (uint i = 0; i < k; i++) {                GraphPart p, q = parts[i];                string file = prefix + "." + to_string(i);                expect(p.load(file.c_str()) && p.global == q.global && p.owner == q.owner                       && p.off == q.off && p.tgt == q.tgt && p.wt == q.wt && p.owned == q.owned,                       "GraphPart laden");                remove(file.c_str());                for (uint l = 0; l < q.owned; l++) {                    expect(part[q.global[l]] == i, "split eigene Knoten");                    for (uint e = q.off[l]; e < q.off[l + 1]; e++) {                        local.insert({ { q.global[l], q.global[q.tgt[e]] }, q.wt[e] });                    }                }                for (uint x = 0; x < q.ghosts(); x++) {                    expect(q.owner[x] == part[q.global[q.owned + x]], "split Geisterknoten");                }            }            expect(local == edges, "split Kanten");        }    }    // Beschädigte Teile dürfen nicht geladen werden.    vector<uint> part;    vector<GraphPart> parts;    FrozenGraph<V> g = checkGraphs().back();    partition(g, 2, part);    split(g, part, 2, parts);    const GraphPart& q = parts[0];    string file = prefix + ".0";    vector<GraphPart> bad(6, q);    bad[0].off[0] = 1;    swap(bad[1].off[1], bad[1].off[2]);    bad[2].tgt.back() = q.global.size();    bad[3].global[0] = q.n;    bad[4].owner.back() = q.parts;    bad[5].id = q.parts;    for (auto& p : bad) {        GraphPart r;        expect(p.save(file.c_str()) && !r.load(file.c_str()), "GraphPart prüfen");    }    // Abgeschnittene Datei und Größen, die die Datei nicht enthalten kann.    q.save(file.c_str());    string bytes;    {        ifstream in(file, ios::binary);        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());    }    for (uint k = 0; k < 3; k++) {        string b = bytes;        if (k == 0) b.resize(b.size() - 4);        else {            uint64_t huge = uint64_t(1) << (k == 1 ? 40 : 62);            memcpy(&b[16 + 8 * k], &huge, sizeof(huge));        }        ofstream(file, ios::binary) << b;        GraphPart r;        expect(!r.load(file.c_str()), "GraphPart Größen");    }    GraphPart r;    expect(q.save(file.c_str()) && r.load(file.c_str()) && r.tgt == q.tgt, "GraphPart laden");    remove(file.c_str());}// Suchen des Teilnehmers mit dem Teil part über t: distBfs und// (falls sp) deltaStepping, jeweils mit gather bei Teilnehmer 0// eingesammelt.bool searchPart (const FrozenGraph<V>& g, const GraphPart& part, uint s,                 bool sp, Transport& t, BFS<V>& bfsRes, SP<V>& spRes) {    PartResult pr;    bool ok = distBfs(part, s, t, pr) && gather(part, pr, t, g.vs, bfsRes);    if (sp) ok = deltaStepping(part, s, 5, t, pr)                 && gather(part, pr, t, g.vs, spRes) && ok;    return ok;}// searchPart mit den Teilen parts als Threads (SharedTransport).bool searchThreads (const FrozenGraph<V>& g, const vector<GraphPart>& parts,                    uint s, bool sp, BFS<V>& bfsRes, SP<V>& spRes) {    uint k = parts.size();    atomic<uint> errors(0);    SharedHub hub(k);    vector<thread> threads;    for (uint r = 0; r < k; r++) {        threads.emplace_back([&, r] {            SharedTransport t(hub, r);            if (!searchPart(g, parts[r], s, sp, t, bfsRes, spRes)) errors++;        });    }    for (auto& t : threads) t.join();    return errors == 0;}// searchPart mit den Teilen parts als Prozesse, die über socketMesh// verbunden sind (SocketTransport). Teilnehmer 0 ist dieser Prozess,// die übrigen werden mit fork erzeugt und melden Fehler über ihren// Exit-Status.bool searchProcesses (const FrozenGraph<V>& g, const vector<GraphPart>& parts,                      uint s, bool sp, BFS<V>& bfsRes, SP<V>& spRes) {    uint k = parts.size();    vector<vector<int>> fds;    if (!socketMesh(k, fds)) return false;    vector<pid_t> pids;    for (uint r = 1; r < k; r++) {        pid_t pid = fork();        if (pid == 0) {            closeOthers(r, fds);            SocketTransport t(r, fds[r]);            BFS<V> b;            SP<V> d;            _exit(searchPart(g, parts[r], s, sp, t, b, d) ? 0 : 1);        }        pids.push_back(pid);    }    closeOthers(0, fds);    bool ok;    {        SocketTransport t(0, fds[0]);        ok = searchPart(g, parts[0], s, sp, t, bfsRes, spRes);    }    for (pid_t pid : pids) {        int status = 0;        ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status)             && WEXITSTATUS(status) == 0 && ok;    }    return ok;}// Verteilte Suchen mit k Teilnehmern als Threads und als Prozesse:// distBfs und deltaStepping (nur ohne negative Gewichte), eingesammelt// mit gather, gegen die Referenzebenen und -distanzen.void checkDistributed () {    for (auto& g : checkGraphs()) {        vector<uint> sources = sample(g);        sources.resize(min(sources.size(), size_t(5)));        for (uint k : { 1, 3 }) {            vector<uint> part;            partition(g, k, part);            vector<GraphPart> parts;            split(g, part, k, parts);            for (uint s : sources) {                bool sp = !negative(g);                for (bool processes : { false, true }) {                    BFS<V> bfsRes;                    SP<V> spRes;                    if (processes) {                        expect(searchProcesses(g, parts, s, sp, bfsRes, spRes),                               "distributed Sockets");                    }                    else {                        expect(searchThreads(g, parts, s, sp, bfsRes, spRes),                               "distributed Übertragung");                    }                    vector<uint> l;                    levels(g, s, l);                    for (uint v = 0; v < g.size(); v++) {                        expect(bfsRes.dist[g.vs[v]] == l[v], "distBfs");                    }                    vector<double> d;                    if (!sp || !distances(g, s, d)) continue;                    for (uint v = 0; v < g.size(); v++) {                        double x = spRes.dist[g.vs[v]];                        expect(near(x, d[v]), "deltaStepping");                        if (v == s || d[v] == numeric_limits<double>::infinity()) continue;                        uint p = g.index(spRes.pred[g.vs[v]]);                        expect(p != NONE && near(d[p] + length(g, { p, v }), d[v]),                               "deltaStepping Vorgänger");                    }                }            }        }    }}// Platzierung auf NUMA-Knoten: Nach place (mit jeder Platzierung; ob// das Betriebssystem sie umsetzt, spielt keine Rolle) muss der Graph// unverändert sein, und PageRank mit gebundenen Threads muss weiter// die einfache Potenziteration ergeben.void checkNuma () {    NumaTopology topo;    ThreadPool pool(4);    bool pinned = pool.pin(topo.assign(pool.size()));    vector<FrozenGraph<V>> gs = checkGraphs();    const FrozenGraph<V>& g = gs.back();    vector<double> tele(g.size(), 1.0 / g.size());    vector<double> ref = pagerankPlain(g, tele, 30, 0.85);    for (Placement p : { PLACE_DEFAULT, PLACE_INTERLEAVE, PLACE_PARTITIONED }) {        FrozenGraph<V> h = g;        place(h, p, topo, pool.size());        expect(h.off == g.off && h.tgt == g.tgt && h.wt == g.wt, "numa Graph");        PageRank<double> res;        res.maxIter = 30;        res.tolerance = 0;        pagerank(h, res, pool);        place(res.rank, p, topo, pool.size());        for (uint v = 0; v < g.size(); v++) {            expect(fabs(res.rank[v] - ref[v]) <= 1e-12, "numa pagerank");        }    }    // defaultPool() nach pinDefaultPool, in einem eigenen Prozess, weil    // der Pool nur bei seiner Erzeugung gebunden wird: Jeder Thread läuft    // auf seinem Prozessor aus assign (sofern das Binden hier überhaupt    // erlaubt ist), und pagerank rechnet damit dasselbe.    pid_t pid = fork();    if (pid == 0) {        pinDefaultPool(topo);        ThreadPool& d = defaultPool();        vector<uint> cpus = topo.assign(d.size());        bool ok = true;        for (uint w = 0; w < d.size() && pinned; w++) {            cpu_set_t set;            pthread_t t = w == 0 ? pthread_self() : d.workers[w - 1].native_handle();            ok = pthread_getaffinity_np(t, sizeof(set), &set) == 0                 && CPU_COUNT(&set) == 1 && CPU_ISSET(cpus[w], &set) && ok;        }        PageRank<double> res;        res.maxIter = 30;        res.tolerance = 0;        pagerank(g, res);        for (uint v = 0; v < g.size(); v++) {            ok = ok && fabs(res.rank[v] - ref[v]) <= 1e-12;        }        _exit(ok ? 0 : 1);    }    int status = 0;    expect(pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status)           && WEXITSTATUS(status) == 0, "numa defaultPool");}// Große Seiten: Ein Graph, dessen Felder über HUGE_MIN liegen, wird mit// jeder Seitenart (mit Rückfall auf schwächere Arten) kopiert; die// Felder müssen in HugeRegistry verzeichnet sein, Breitensuche und// Dijkstra müssen dieselben Ergebnisse wie ohne große Seiten liefern,// und nach dem Freigeben darf kein Bereich übrig bleiben.void checkHugePages () {    const uint n = 200000;    mt19937 rng(8);    FrozenGraph<uint> g;    for (uint v = 0; v < n; v++) {        g.vs.push_back(v);        g.idx[v] = v;        g.off.push_back(g.tgt.size());        for (uint i = 0; i < 4; i++) {            g.tgt.push_back(rng() % n);            g.wt.push_back(double(1 + rng() % 20));        }    }    g.off.push_back(g.tgt.size());    Workspace ws;    dijkstra(g, 0, ws);    vector<double> dist(n), hops(n);    for (uint v = 0; v < n; v++) dist[v] = ws.distance(v);    bfs(g, 0, ws);    for (uint v = 0; v < n; v++) hops[v] = ws.distance(v);    HugeRegistry& r = HugeRegistry::get();    for (int mode : { HUGE_THP, HUGE_2MB, HUGE_1GB }) {        hugePages() = mode;        {            FrozenGraph<uint> h = g;            Workspace hw;            {                lock_guard<mutex> guard(r.lock);                expect(r.regions.count(h.tgt.data()) && r.regions.count(h.wt.data()),                       "hugepages Bereiche");            }            dijkstra(h, 0, hw);            for (uint v = 0; v < n; v++) expect(hw.distance(v) == dist[v], "hugepages dijkstra");            bfs(h, 0, hw);            for (uint v = 0; v < n; v++) expect(hw.distance(v) == hops[v], "hugepages bfs");            hugePages() = HUGE_OFF;        }        lock_guard<mutex> guard(r.lock);        expect(r.regions.empty(), "hugepages freigeben");    }}// Vorausladen: bfs und dijkstra aus csr.h mit verschiedenen// Vorausladeabständen (auch 0 und länger als jede Nachfolgerliste)// gegen die Referenzebenen und -distanzen.void checkPrefetch () {    uint old = prefetchDistance();    for (auto& g : checkGraphs()) {        for (uint s : sample(g)) {            vector<uint> l;            vector<double> d;            levels(g, s, l);            bool sp = !negative(g) && distances(g, s, d);            for (uint pd : { 0, 1, 3, 8, 64 }) {                prefetchDistance() = pd;                Workspace ws;                bfs(g, s, ws);                for (uint v = 0; v < g.size(); v++) {                    expect(ws.seen(v) ? ws.dist[v] == l[v] : l[v] == NONE, "prefetch bfs");                }                if (!sp) continue;                dijkstra(g, s, ws);                for (uint v = 0; v < g.size(); v++) {                    expect(near(ws.distance(v), d[v]), "prefetch dijkstra");                }            }            prefetchDistance() = old;        }    }}// Durchläufe mit Bitfeldern gegen dfs, topsort, bfs und scc aus// graph.h: gleiche Reihenfolgen, Zeiten und Farben, gleiche Ebenen und// Komponenten.void checkTraversal () {    for (auto& g : checkGraphs(300)) {        WeightedGraph<V> w = thaw(g);        DFS<V> ref, res;        dfs(w, ref);        expect(dfs(g, res, DFS_SEQ | DFS_TIMES | DFS_COLORS) && res.seq == ref.seq               && res.det == ref.det && res.fin == ref.fin && res.color_map == ref.color_map,               "traversal dfs");        vector<uint> order;        list<V> seq;        dfs(g, order);        for (uint v : order) seq.push_back(g.vs[v]);        expect(seq == ref.seq, "traversal dfs Reihenfolge");        list<V> sorted, sortedRef;        bool ok = topsort(w, sortedRef);        expect(topsort(g, sorted) == ok && (!ok || sorted == sortedRef), "traversal topsort");        Bitset seen;        vector<uint> lev;        for (uint s : sample(g)) {            vector<uint> l;            levels(g, s, l);            bfs(g, s, seen, order, &lev);            uint count = 0;            for (uint v = 0; v < g.size(); v++) count += l[v] != NONE;            expect(order.size() == count && lev.back() == count, "traversal bfs");            for (size_t d = 0; d + 1 < lev.size(); d++) {                for (uint i = lev[d]; i < lev[d + 1]; i++) {                    expect(l[order[i]] == d && seen.test(order[i]), "traversal bfs Ebenen");                }            }        }        list<list<V>> comps;        scc(g, comps);        set<set<uint>> parts;        for (auto& c : comps) {            set<uint> x;            for (auto& v : c) x.insert(g.index(v));            parts.insert(x);        }        expect(parts == sccReference(g) && comps.size() == parts.size(), "traversal scc");    }}// Knotenprogramme mit 4 Threads: pregelBfs und pregelSssp gegen die// Referenzebenen und -distanzen, pregelPageRank gegen die einfache// Potenziteration, pregelComponents gegen scc aus graph.h auf der// ungerichteten Version.void checkPregel () {    ThreadPool pool(4);    for (auto& g : checkGraphs(300)) {        for (uint s : sample(g)) {            vector<uint> l, dist;            levels(g, s, l);            pregelBfs(g, s, dist, pool);            expect(dist == l, "pregelBfs");            vector<double> d, sp;            if (negative(g) || !distances(g, s, d)) continue;            pregelSssp(g, s, sp, pool);            expect(near(sp, d), "pregelSssp");        }        vector<double> rank, tele(g.size(), 1.0 / g.size());        pregelPageRank(g, rank, 30, 0.85, pool);        vector<double> ref = pagerankPlain(g, tele, 30, 0.85);        for (uint v = 0; v < g.size(); v++) {            expect(fabs(rank[v] - ref[v]) <= 1e-12, "pregelPageRank");        }        FrozenGraph<V> u = symmetric(g);        vector<uint> labels;        set<set<uint>> comps = sccReference(u);        expect(pregelComponents(u, labels, pool) == comps.size()               && classes(labels) == comps, "pregelComponents");        for (auto& c : comps) {            for (uint v : c) expect(labels[v] == *c.begin(), "pregelComponents Marken");        }    }}// Halbring-Produkte mit 4 Threads (auf dem Zufallsgraphen auch in// Pull-Richtung): bfsSemiring gegen die Referenzebenen,// bellmanFordSemiring gegen die Referenzdistanzen einschließlich der// Erkennung negativer Zyklen.void checkSemiring () {    ThreadPool pool(4);    for (auto& g : checkGraphs()) {        FrozenGraph<V> t = g.transpose();        for (uint s : sample(g)) {            vector<uint> l, dist;            levels(g, s, l);            bfsSemiring(g, t, s, dist, pool);            expect(dist == l, "bfsSemiring");            vector<double> d, sp;            bool ok = distances(g, s, d);            expect(bellmanFordSemiring(g, t, s, sp, pool) == ok, "bellmanFordSemiring Zyklus");            if (ok) expect(near(sp, d), "bellmanFordSemiring");        }    }}// Breiten der breitesten Wege vom Knoten s (Index) aus in w speichern,// ermittelt über Erreichbarkeit: Für jedes Gewicht x (absteigend)// erhalten die Knoten, die erstmals über Kanten mit Gewicht >= x// erreichbar sind, die Breite x.void widths (const FrozenGraph<V>& g, uint s, vector<double>& w) {    const double inf = numeric_limits<double>::infinity();    w.assign(g.size(), -inf);    w[s] = inf;    set<double> xs(g.wt.begin(), g.wt.end());    if (!g.weighted()) xs.insert(1);    for (auto x = xs.rbegin(); x != xs.rend(); x++) {        vector<uint> q = { s };        vector<bool> seen(g.size(), false);        seen[s] = true;        for (size_t i = 0; i < q.size(); i++) {            for (uint e = g.off[q[i]]; e < g.off[q[i] + 1]; e++) {                uint v = g.tgt[e];                if (g.weight(e) < *x || seen[v]) continue;                seen[v] = true;                q.push_back(v);                if (w[v] == -inf) w[v] = *x;            }        }    }}// Breiteste Wege: widestPath auf WeightedGraph und auf FrozenGraph// (auch mit Zielknoten) gegen die Breiten über Erreichbarkeit, auf der// ungerichteten Version zusätzlich BottleneckIndex.void checkWidest () {    for (auto& g : checkGraphs(300)) {        WeightedGraph<V> m = thaw(g);        FrozenGraph<V> u = symmetric(g);        BottleneckIndex idx;        buildBottleneck(u, idx);        Workspace ws;        for (uint s : sample(g)) {            vector<double> ref;            widths(g, s, ref);            SP<V> res;            widestPath(m, g.vs[s], res);            widestPath(g, s, ws);            for (uint v = 0; v < g.size(); v++) {                expect(res.dist[g.vs[v]] == ref[v], "widestPath WeightedGraph");                expect(ws.seen(v) ? ws.dist[v] == ref[v]                                  : ref[v] == -numeric_limits<double>::infinity(),                       "widestPath FrozenGraph");            }            for (uint t : sample(g)) {                widestPath(g, s, ws, t);                expect(ws.seen(t) ? ws.dist[t] == ref[t]                                  : ref[t] == -numeric_limits<double>::infinity(),                       "widestPath Zielknoten");            }            widths(u, s, ref);            for (uint v = 0; v < u.size(); v++) {                expect(idx.width(s, v) == ref[v], "BottleneckIndex");            }        }    }}// Prüfungen nach Namen (für check [Name]).struct Check {    const char* name;    void (*run) ();};Check checks [] = {    { "server", checkServer },    { "batch", checkBatch },    { "apsp", checkApsp },    { "johnson", checkJohnson },    { "betweenness", checkBetweenness },    { "pagerank", checkPageRank },    { "components", checkComponents },    { "biconnected", checkBiconnected },    { "flow", checkFlow },    { "kpaths", checkKPaths },    { "reach", checkReach },    { "labeling", checkLabeling },    { "dynamic", checkDynamic },    { "incremental", checkIncremental },    { "cache", checkCache },    { "external", checkExternal },    { "partition", checkPartition },    { "distributed", checkDistributed },    { "numa", checkNuma },    { "hugepages", checkHugePages },    { "prefetch", checkPrefetch },    { "traversal", checkTraversal },    { "pregel", checkPregel },    { "semiring", checkSemiring },    { "widest", checkWidest },};// Hauptprogramm.// Auswahl des Algorithmus durch das erste Kommandozeilenargument:// bfs -> breadth first search// dfs -> depth first search// sort -> topological sort// scc -> strongly connected components// prim -> Prim// bell -> Bellman-Ford// dijk -> Dijkstra// serve -> Abfrageserver: serve <Graphdatei> <Socket> [Threads] [Cache-MB]// query -> Anfrage an den Server: query <Socket> sp|bfs|reach <s> <t>// check -> Prüfungen gegen die Referenzimplementierungen: check [Name]// Auswahl des Testgraphen durch das zweite Kommandozeilenargument.// (Bei den Algorithmen prim, bell und dijk muss ein gewichteter// Graph ausgewählt werden.)// Auswahl des Startknotens durch das optionale dritte// Kommandozeilenargument (Standardwert ist "A").int main (int argc, char* argv []) {    // Kommandozeilenargumente.    //string a = argv[1];				// Algorithmus.    string a = argv[1];				// Algorithmus.    bool noGraph = a == "serve" || a == "query" || a == "check";    Graph<V>* g = noGraph ? nullptr : graphs[stoi( argv[2])];	// Graph.    V s = argc > 3 ? argv[3] : "A";		// Startknoten.    // Gewünschten Algorithmus ausführen und sein Ergebnis ausgeben.    if (a == "bfs") {        BFS<V> res;        bfs(*g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            uint d = res.dist[v];            if (d == res.INF) cout << " inf" << endl;            else cout << " " << d << endl;        }    }    else if (a == "dfs") {        DFS<V> res;        dfs(*g, res);        for (V v : res.seq) {            cout << v << " " << res.det[v] << " " << res.fin[v] << endl;        }    }    else if (a == "sort") {        list<V> res;        if (topsort(*g, res)) {            for (V v : res) cout << v << endl;        }        else {            cout << "cycle" << endl;        }    }    else if (a == "scc") {        list<list<V>> res;        scc(*g, res);        for (list<V> c : res) {            c.sort();            for (V v : c) cout << v << " ";            cout << endl;        }    }    else if (a == "prim") {        Pred<V> res;        prim(*(WeightedGraph<V>*)g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            cout << endl;        }    }    else if (a == "bell") {        SP<V> res;        if (bellmanFord(*(WeightedGraph<V>*)g, s, res)) {            for (V v : g->vertices()) {                path(s, v, res);                cout << " " << res.dist[v] << endl;            }        }        else {            cout << "negative cycle" << endl;        }    }    else if (a == "dijk") {        SP<V> res;        dijkstra(*(WeightedGraph<V>*)g, s, res);        for (V v : g->vertices()) {            path(s, v, res);            cout << " " << res.dist[v] << endl;        }    }    else if (a == "serve") {        // Graph einmal laden und danach beliebig viele Anfragen        // nebenläufig beantworten.        WeightedGraph<uint> wg = readGraph(argv[2]);        FrozenGraph<uint> f = freeze(wg);        uint threads = argc > 4 ? atoi(argv[4])                                : max(1u, thread::hardware_concurrency());        size_t cache = argc > 5 ? size_t(atol(argv[5])) << 20 : 0;        if (!serve(f, argv[3], threads, cache)) {            cout << "socket not usable: " << argv[3] << endl;        }    }    else if (a == "query") {        Request req = { opCode(argv[3]), uint32_t(atoi(argv[4])),                        uint32_t(atoi(argv[5])) };        Response res;        vector<uint32_t> p;        int fd = connectServer(argv[2]);        if (fd < 0 || !query(fd, req, res, p)) {            cout << "server not reachable: " << argv[2] << endl;        }        else if (res.status == ST_OK) {            cout << res.dist;            for (auto v : p) cout << " " << v;            cout << endl;        }        else if (res.status == ST_UNREACHABLE) {            cout << "unreachable" << endl;        }        else {            cout << "invalid request" << endl;        }        if (fd >= 0) close(fd);    }    else if (a == "check") {        // Alle Prüfungen oder nur die mit dem Namen argv[2] ausführen.        bool found = false;        for (Check& c : checks) {            if (argc > 2 && argv[2] != string(c.name)) continue;            found = true;            uint before = failures;            c.run();            cout << (failures == before ? "ok " : "FAILED ") << c.name << endl;        }        if (!found) cout << "unknown check: " << argv[2] << endl;        return found && failures == 0 ? 0 : 1;    }    else {        cout << "unknown algorithm: " << a << endl;    }}
\ No newline at end of file
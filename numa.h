@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  NUMA-Topologie und Platzierung von Feldern
+ */
+
+// Knoten (Sockel) des Rechners mit ihren Prozessoren, gelesen aus
+// /sys/devices/system/node. ids[i] ist die Nummer des Knotens i beim
+// Betriebssystem, cpus[i] die Liste seiner Prozessoren.
+// Ohne NUMA-Information gibt es einen einzigen Knoten mit allen
+// Prozessoren.
+struct NumaTopology {
+    vector<uint> ids;
+    vector<vector<uint>> cpus;
+
+    NumaTopology () {
+        for (uint id = 0; id < 64; id++) {
+            ifstream in("/sys/devices/system/node/node" + to_string(id)
+                        + "/cpulist");
+            if (!in) continue;
+            vector<uint> list;
+            string part;
+            while (getline(in, part, ',')) {
+                uint a, b;
+                char dash;
+                istringstream ps(part);
+                if (!(ps >> a)) continue;
+                b = a;
+                if (ps >> dash) ps >> b;
+                for (uint c = a; c <= b; c++) list.push_back(c);
+            }
+            if (list.empty()) continue;
+            ids.push_back(id);
+            cpus.push_back(list);
+        }
+        if (ids.empty()) {
+            ids.push_back(0);
+            cpus.emplace_back();
+            for (uint c = 0; c < max(1u, thread::hardware_concurrency()); c++) {
+                cpus[0].push_back(c);
+            }
+        }
+    }
+
+    // Anzahl der Knoten.
+    uint nodes () const { return ids.size(); }
+
+    // Knoten, auf dem Thread w eines Pools mit n Threads läuft: Die
+    // Threads werden blockweise auf die Knoten verteilt, damit
+    // benachbarte Teile eines Indexbereichs auf demselben Knoten liegen.
+    uint node (uint w, uint n) const { return uint(uint64_t(w) * nodes() / n); }
+
+    // Prozessoren für die n Threads eines Pools (für ThreadPool::pin):
+    // Thread w erhält reihum einen Prozessor seines Knotens node(w, n).
+    vector<uint> assign (uint n) const {
+        vector<uint> res(n), next(nodes(), 0);
+        for (uint w = 0; w < n; w++) {
+            uint k = node(w, n);
+            res[w] = cpus[k][next[k]++ % cpus[k].size()];
+        }
+        return res;
+    }
+};
+
+// defaultPool() bei seiner Erzeugung gemäß topo binden lassen (wie
+// pool.pin(topo.assign(pool.size())) bei einem eigenen Pool).
+// Muss vor dem ersten Aufruf von defaultPool() erfolgen.
+inline void pinDefaultPool (const NumaTopology& topo = NumaTopology()) {
+    defaultPoolCpus() = topo.assign(max(1u, thread::hardware_concurrency()));
+}
+
+// Platzierung eines Feldes auf die Knoten:
+// PLACE_DEFAULT belässt die Seiten dort, wo sie beim ersten Schreiben
+// entstanden sind (bei std::vector also beim erzeugenden Thread),
+// PLACE_INTERLEAVE verteilt die Seiten reihum auf alle Knoten,
+// PLACE_PARTITIONED legt den Teil des Feldes, den Thread w eines Pools
+// zuerst bearbeitet, auf den Knoten dieses Threads (wie es das erste
+// Schreiben durch gebundene Threads ergäbe).
+enum Placement { PLACE_DEFAULT, PLACE_INTERLEAVE, PLACE_PARTITIONED };
+
+// Speicherrichtlinie mode mit Knotenmaske mask auf die Seiten des
+// Bereichs [p, p + bytes) anwenden und vorhandene Seiten verschieben.
+inline bool bindPages (const void* p, size_t bytes, int mode, uint64_t mask) {
+    if (bytes == 0) return true;
+    return syscall(SYS_mbind, const_cast<void*>(p), bytes, mode, &mask,
+                   64, MPOL_MF_MOVE) == 0;
+}
+
+// Feld a gemäß p platzieren; bounds (threads + 1 Einträge) gibt die
+// Indexbereiche der Threads an.
+// PLACE_PARTITIONED nützt nur, wenn die Threads des Pools, der das Feld
+// bearbeitet, mit ThreadPool::pin gemäß NumaTopology::assign gebunden
+// sind; defaultPool() ist das nur nach pinDefaultPool.
+// Die Grenzen werden auf Seiten abgerundet (eine Seite, die zwei
+// Bereiche enthält, gehört zum hinteren). Resultatwert false, wenn das
+// Betriebssystem die Platzierung ablehnt (z. B. ohne NUMA-Unterstützung).
+template <typename T, typename A>
+bool place (const vector<T, A>& a, Placement p, const NumaTopology& topo,
+            const vector<size_t>& bounds) {
+    if (p == PLACE_DEFAULT || a.empty()) return true;
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t base = reinterpret_cast<uintptr_t>(a.data());
+    uintptr_t end = base + a.size() * sizeof(T);
+    base &= ~(page - 1);
+    if (p == PLACE_INTERLEAVE) {
+        uint64_t mask = 0;
+        for (uint id : topo.ids) mask |= uint64_t(1) << id;
+        return bindPages(reinterpret_cast<void*>(base), end - base,
+                         MPOL_INTERLEAVE, mask);
+    }
+    bool ok = true;
+    uint n = bounds.size() - 1;
+    for (uint w = 0; w < n; w++) {
+        uintptr_t b = reinterpret_cast<uintptr_t>(a.data() + bounds[w]);
+        uintptr_t e = reinterpret_cast<uintptr_t>(a.data() + bounds[w + 1]);
+        b = w == 0 ? base : b & ~(page - 1);
+        e = w == n - 1 ? end : e & ~(page - 1);
+        if (e <= b) continue;
+        uint id = topo.ids[topo.node(w, n)];
+        ok = bindPages(reinterpret_cast<void*>(b), e - b, MPOL_PREFERRED,
+                       uint64_t(1) << id) && ok;
+    }
+    return ok;
+}
+
+// Anfänge der Indexbereiche der threads Threads eines Pools für ein
+// Feld mit count Einträgen (wie ThreadPool::parallelRange).
+inline vector<size_t> evenBounds (size_t count, uint threads) {
+    vector<size_t> b(threads + 1);
+    for (uint w = 0; w <= threads; w++) b[w] = count * w / threads;
+    return b;
+}
+
+// Knotenfeld a (ein Eintrag je Knoten, z. B. Distanzen oder Ränge) für
+// einen Pool mit threads Threads platzieren.
+template <typename T, typename A>
+bool place (const vector<T, A>& a, Placement p, const NumaTopology& topo,
+            uint threads) {
+    return place(a, p, topo, evenBounds(a.size(), threads));
+}
+
+// Felder des Graphen g für einen Pool mit threads Threads platzieren:
+// off nach Knotenbereichen, tgt und wt jeweils mit den Kanten dieser
+// Knoten, sodass ein Thread, der über seine Knoten läuft, auch deren
+// Kanten lokal vorfindet.
+template <typename V>
+bool place (const FrozenGraph<V>& g, Placement p, const NumaTopology& topo,
+            uint threads) {
+    vector<size_t> vb = evenBounds(g.size(), threads), eb(threads + 1);
+    for (uint w = 0; w <= threads; w++) eb[w] = g.off[vb[w]];
+    bool ok = place(g.off, p, topo, vb);
+    ok = place(g.tgt, p, topo, eb) && ok;
+    return place(g.wt, p, topo, eb) && ok;
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "csr.h"
+
+/*
+ *  Zerlegung von Graphen (Multilevel-Partitionierung)
+ */
+
+// Ungerichteter Hilfsgraph der Partitionierung mit Knotengewichten vw
+// (Anzahl der zusammengefassten ursprünglichen Knoten) und
+// Kantengewichten ew (Anzahl der zusammengefassten ursprünglichen
+// Kanten) im CSR-Format. Jede Kante ist in beiden Richtungen
+// gespeichert, Schleifen gibt es nicht.
+struct CoarseGraph {
+    vector<uint> off, adj, ew, vw;
+
+    uint size () const { return vw.size(); }
+};
+
+// Hilfsgraph aus den Kanten (u, v) von g aufbauen (Richtungen und
+// Gewichte werden ignoriert, Mehrfachkanten zusammengefasst).
+template <typename V>
+void symmetrize (const FrozenGraph<V>& g, CoarseGraph& h) {
+    uint n = g.size();
+    vector<vector<uint>> nb(n);
+    for (uint u = 0; u < n; u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            uint v = g.tgt[e];
+            if (u == v) continue;
+            nb[u].push_back(v);
+            nb[v].push_back(u);
+        }
+    }
+    h.vw.assign(n, 1);
+    h.off.assign(n + 1, 0);
+    h.adj.clear();
+    h.ew.clear();
+    for (uint u = 0; u < n; u++) {
+        sort(nb[u].begin(), nb[u].end());
+        for (size_t i = 0; i < nb[u].size(); ) {
+            size_t j = i;
+            while (j < nb[u].size() && nb[u][j] == nb[u][i]) j++;
+            h.adj.push_back(nb[u][i]);
+            h.ew.push_back(j - i);
+            i = j;
+        }
+        h.off[u + 1] = h.adj.size();
+        vector<uint>().swap(nb[u]);
+    }
+}
+
+// Den Graphen h durch Zusammenfassen von Knotenpaaren vergröbern
+// (heavy edge matching): Die Knoten werden in zufälliger Reihenfolge
+// besucht und mit dem noch freien Nachbarn über die schwerste Kante
+// gepaart. cmap[v] ist danach der Knoten von c, in dem v aufgeht.
+inline void coarsen (const CoarseGraph& h, CoarseGraph& c, vector<uint>& cmap,
+                     mt19937& rng) {
+    uint n = h.size();
+    vector<uint> order(n), mate(n, NONE);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+    for (uint u : order) {
+        if (mate[u] != NONE) continue;
+        uint best = u, w = 0;
+        for (uint x = h.off[u]; x < h.off[u + 1]; x++) {
+            uint v = h.adj[x];
+            if (mate[v] == NONE && h.ew[x] > w) {
+                best = v;
+                w = h.ew[x];
+            }
+        }
+        mate[u] = best;
+        mate[best] = u;
+    }
+
+    cmap.assign(n, NONE);
+    uint cn = 0;
+    for (uint u = 0; u < n; u++) {
+        if (cmap[u] != NONE) continue;
+        cmap[u] = cmap[mate[u]] = cn++;
+    }
+
+    // Kanten zusammenfassen; pos[x] ist die Position der Kante zum
+    // groben Knoten x in der gerade gebauten Liste (oder NONE).
+    c.vw.assign(cn, 0);
+    c.off.assign(cn + 1, 0);
+    c.adj.clear();
+    c.ew.clear();
+    vector<uint> pos(cn, NONE);
+    uint cu = 0;
+    for (uint u = 0; u < n; u++) {
+        if (cmap[u] != cu) continue;
+        size_t start = c.adj.size();
+        for (uint f : { u, mate[u] }) {
+            c.vw[cu] += h.vw[f];
+            for (uint x = h.off[f]; x < h.off[f + 1]; x++) {
+                uint cv = cmap[h.adj[x]];
+                if (cv == cu) continue;
+                if (pos[cv] == NONE) {
+                    pos[cv] = c.adj.size();
+                    c.adj.push_back(cv);
+                    c.ew.push_back(0);
+                }
+                c.ew[pos[cv]] += h.ew[x];
+            }
+            if (mate[u] == u) break;
+        }
+        for (size_t x = start; x < c.adj.size(); x++) pos[c.adj[x]] = NONE;
+        c.off[++cu] = c.adj.size();
+    }
+}
+
+// Anfangszerlegung des (groben) Graphen h in k Teile: Die Knoten
+// werden in Breitensuchreihenfolge der Reihe nach auf die Teile
+// verteilt, bis jeweils ein k-tel des Gesamtgewichts erreicht ist.
+inline void growParts (const CoarseGraph& h, uint k, vector<uint>& part) {
+    uint n = h.size();
+    uint64_t total = accumulate(h.vw.begin(), h.vw.end(), uint64_t(0));
+    vector<uint> order;
+    vector<bool> seen(n, false);
+    for (uint r = 0; r < n; r++) {
+        if (seen[r]) continue;
+        seen[r] = true;
+        order.push_back(r);
+        for (size_t i = order.size() - 1; i < order.size(); i++) {
+            uint u = order[i];
+            for (uint x = h.off[u]; x < h.off[u + 1]; x++) {
+                if (!seen[h.adj[x]]) {
+                    seen[h.adj[x]] = true;
+                    order.push_back(h.adj[x]);
+                }
+            }
+        }
+    }
+    part.assign(n, 0);
+    uint64_t sum = 0;
+    for (uint u : order) {
+        part[u] = min<uint64_t>(sum * k / max<uint64_t>(total, 1), k - 1);
+        sum += h.vw[u];
+    }
+}
+
+// Zerlegung part des Graphen h durch Label Propagation verbessern:
+// Jeder Knoten wechselt in den benachbarten Teil, mit dem er über die
+// schwersten Kanten verbunden ist, sofern das den Schnitt verkleinert
+// und der Zielteil danach höchstens maxW wiegt. Knoten eines zu
+// schweren Teils dürfen auch mit Verlust in einen leichteren Teil
+// wechseln. Höchstens rounds Runden, Abbruch, sobald keiner mehr
+// wechselt.
+inline void refine (const CoarseGraph& h, uint k, vector<uint>& part,
+                    uint64_t maxW, uint rounds = 8) {
+    vector<uint64_t> weight(k, 0), conn(k, 0);
+    for (uint u = 0; u < h.size(); u++) weight[part[u]] += h.vw[u];
+    vector<uint> touched;
+    for (uint r = 0; r < rounds; r++) {
+        uint moves = 0;
+        for (uint u = 0; u < h.size(); u++) {
+            uint cur = part[u];
+            for (uint x = h.off[u]; x < h.off[u + 1]; x++) {
+                uint p = part[h.adj[x]];
+                if (conn[p] == 0) touched.push_back(p);
+                conn[p] += h.ew[x];
+            }
+            bool over = weight[cur] > maxW;
+            uint best = cur;
+            for (uint p : touched) {
+                if (p == cur || weight[p] + h.vw[u] > maxW) continue;
+                if (best == cur ? (over || conn[p] > conn[cur])
+                                : conn[p] > conn[best]) {
+                    best = p;
+                }
+            }
+            for (uint p : touched) conn[p] = 0;
+            touched.clear();
+            if (best == cur) continue;
+            weight[cur] -= h.vw[u];
+            weight[best] += h.vw[u];
+            part[u] = best;
+            moves++;
+        }
+        if (moves == 0) break;
+    }
+}
+
+// Den Graphen g in k Teile zerlegen und part[v] auf den Teil des
+// Knotens mit Index v setzen. Jeder Teil enthält höchstens (1 +
+// imbalance) * n / k Knoten (soweit die Nachbarschaften das zulassen),
+// die Anzahl der Kanten zwischen verschiedenen Teilen soll möglichst
+// klein sein (Richtungen und Gewichte werden dabei nicht beachtet).
+// Resultatwert: Anzahl der Kanten (u, v) von g mit part[u] != part[v].
+// Ablauf (Multilevel-Verfahren):
+// 1. Den Graphen wiederholt durch heavy edge matching vergröbern, bis
+//    er höchstens 20 * k Knoten hat oder kaum noch schrumpft.
+// 2. Den gröbsten Graphen durch Breitensuche in k Teile zerlegen.
+// 3. Die Zerlegung Stufe für Stufe auf die feineren Graphen übertragen
+//    und jeweils mit Label Propagation verbessern.
+template <typename V>
+uint64_t partition (const FrozenGraph<V>& g, uint k, vector<uint>& part,
+                    double imbalance = 0.03, uint seed = 1) {
+    uint n = g.size();
+    k = max(k, 1u);
+    part.assign(n, 0);
+    if (k == 1 || n == 0) return 0;
+
+    mt19937 rng(seed);
+    vector<CoarseGraph> levels(1);
+    vector<vector<uint>> cmaps;
+    symmetrize(g, levels[0]);
+    while (levels.back().size() > 20 * k) {
+        CoarseGraph c;
+        vector<uint> cmap;
+        coarsen(levels.back(), c, cmap, rng);
+        if (c.size() > 0.95 * levels.back().size()) break;
+        levels.push_back(move(c));
+        cmaps.push_back(move(cmap));
+    }
+
+    uint64_t maxW = uint64_t((1 + imbalance) * n / k) + 1;
+    vector<uint> p;
+    growParts(levels.back(), k, p);
+    refine(levels.back(), k, p, maxW);
+    for (size_t l = cmaps.size(); l-- > 0; ) {
+        vector<uint> fine(levels[l].size());
+        for (uint v = 0; v < fine.size(); v++) fine[v] = p[cmaps[l][v]];
+        p.swap(fine);
+        refine(levels[l], k, p, maxW);
+    }
+    part.swap(p);
+
+    uint64_t cut = 0;
+    for (uint u = 0; u < n; u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            if (part[u] != part[g.tgt[e]]) cut++;
+        }
+    }
+    return cut;
+}
+
+// Gewichteten Graphen g in k Teile zerlegen (part nach Knotenindizes von
+// freeze(g)).
+template <typename V>
+uint64_t partition (WeightedGraph<V>& g, uint k, vector<uint>& part,
+                    double imbalance = 0.03, uint seed = 1) {
+    return partition(freeze(g), k, part, imbalance, seed);
+}
+
+// Knoten des Graphen g so umnummerieren, dass die Knoten jedes Teils
+// (part) aufeinanderfolgende Indizes erhalten (innerhalb eines Teils in
+// der bisherigen Reihenfolge). Die Nachfolger eines Knotens liegen
+// damit überwiegend in einem kleinen, zusammenhängenden Indexbereich.
+template <typename V>
+FrozenGraph<V> reorder (const FrozenGraph<V>& g, const vector<uint>& part) {
+    uint n = g.size();
+    vector<uint> order(n), rank(n);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&] (uint a, uint b) { return part[a] < part[b]; });
+    for (uint i = 0; i < n; i++) rank[order[i]] = i;
+
+    FrozenGraph<V> r;
+    r.off.assign(n + 1, 0);
+    r.tgt.reserve(g.edges());
+    if (g.weighted()) r.wt.reserve(g.edges());
+    for (uint i = 0; i < n; i++) {
+        uint u = order[i];
+        r.vs.push_back(g.vs[u]);
+        r.idx[g.vs[u]] = i;
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            r.tgt.push_back(rank[g.tgt[e]]);
+            if (g.weighted()) r.wt.push_back(g.wt[e]);
+        }
+        r.off[i + 1] = r.tgt.size();
+    }
+    return r;
+}
+
+/*
+ *  Teilgraphen für die Ausführung in mehreren Prozessen
+ */
+
+// Teil id von parts eines zerlegten Graphen mit n Knoten.
+// Die eigenen Knoten haben die lokalen Indizes 0 bis owned - 1, die
+// Geisterknoten (Ziele von Kanten in andere Teile) die lokalen Indizes
+// ab owned. global bildet jeden lokalen Index auf den Index im
+// ursprünglichen Graphen ab, owner[i] ist der Teil, dem der
+// Geisterknoten owned + i gehört.
+// off, tgt und wt bilden den CSR-Graphen der ausgehenden Kanten der
+// eigenen Knoten (mit lokalen Zielindizes).
+struct GraphPart {
+    uint id = 0, parts = 1, owned = 0;
+    uint64_t n = 0;
+    vector<uint> global, owner;
+    vector<uint> off, tgt;
+    vector<double> wt;
+
+    // Anzahl der Geisterknoten.
+    uint ghosts () const { return global.size() - owned; }
+
+    // Teil in die Datei path schreiben.
+    // Resultatwert false bei einem Fehler.
+    bool save (const char* path) const {
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+        uint32_t head[4] = { MAGIC, id, parts, owned };
+        uint64_t sizes[3] = { n, global.size(), tgt.size() };
+        bool ok = fwrite(head, sizeof(head), 1, f) == 1
+                  && fwrite(sizes, sizeof(sizes), 1, f) == 1
+                  && put(f, global) && put(f, owner) && put(f, off)
+                  && put(f, tgt) && put(f, wt);
+        return fclose(f) == 0 && ok;
+    }
+
+    // Teil aus der Datei path lesen.
+    // Die Größen werden vor dem Anlegen der Felder gegen die Dateigröße
+    // geprüft, danach die Felder selbst: off muss von 0 bis zur
+    // Kantenzahl ansteigen, und alle Indizes (Ziele, globale Indizes,
+    // Teile der Geisterknoten) müssen im gültigen Bereich liegen.
+    // Resultatwert false, wenn die Datei fehlt oder ungültig ist.
+    bool load (const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        uint32_t head[4];
+        uint64_t sizes[3];
+        bool ok = fread(head, sizeof(head), 1, f) == 1 && head[0] == MAGIC
+                  && fread(sizes, sizeof(sizes), 1, f) == 1
+                  && fseek(f, 0, SEEK_END) == 0;
+        long size = ok ? ftell(f) : -1;
+        if (size < 0) ok = false;
+        if (ok) {
+            id = head[1];
+            parts = head[2];
+            owned = head[3];
+            n = sizes[0];
+            // (Zuerst einzeln beschränken, damit die Summe nicht
+            // überläuft.)
+            uint64_t words = uint64_t(size) / 4;
+            ok = id < parts && sizes[1] >= owned && sizes[1] <= words
+                 && sizes[2] <= words && n <= NONE
+                 && sizeof(head) + sizeof(sizes)
+                    + 4 * (2 * sizes[1] + 1 + sizes[2]) + 8 * sizes[2]
+                    == uint64_t(size)
+                 && fseek(f, sizeof(head) + sizeof(sizes), SEEK_SET) == 0
+                 && get(f, global, sizes[1]) && get(f, owner, sizes[1] - owned)
+                 && get(f, off, owned + 1) && get(f, tgt, sizes[2])
+                 && get(f, wt, sizes[2]);
+        }
+        fclose(f);
+        if (!ok || off[0] != 0 || off[owned] != tgt.size()) return false;
+        for (uint l = 0; l < owned; l++) {
+            if (off[l] > off[l + 1]) return false;
+        }
+        for (uint x : tgt) {
+            if (x >= global.size()) return false;
+        }
+        for (uint v : global) {
+            if (v >= n) return false;
+        }
+        for (uint p : owner) {
+            if (p >= parts) return false;
+        }
+        return true;
+    }
+
+    static constexpr uint32_t MAGIC = 0x31545250;	// "PRT1"
+
+    template <typename T>
+    static bool put (FILE* f, const vector<T>& a) {
+        return a.empty() || fwrite(a.data(), sizeof(T), a.size(), f) == a.size();
+    }
+
+    template <typename T>
+    static bool get (FILE* f, vector<T>& a, uint64_t k) {
+        a.resize(k);
+        return k == 0 || fread(a.data(), sizeof(T), k, f) == k;
+    }
+};
+
+// Den Graphen g gemäß der Zerlegung part in k Teile aufteilen.
+template <typename V>
+void split (const FrozenGraph<V>& g, const vector<uint>& part, uint k,
+            vector<GraphPart>& parts) {
+    uint n = g.size();
+    parts.assign(k, GraphPart());
+    // Lokaler Index jedes Knotens in seinem eigenen Teil.
+    vector<uint> local(n);
+    for (uint v = 0; v < n; v++) {
+        GraphPart& p = parts[part[v]];
+        local[v] = p.global.size();
+        p.global.push_back(v);
+    }
+    vector<uint> ghost(n, NONE);
+    for (uint i = 0; i < k; i++) {
+        GraphPart& p = parts[i];
+        p.id = i;
+        p.parts = k;
+        p.n = n;
+        p.owned = p.global.size();
+        p.off.assign(p.owned + 1, 0);
+        for (uint l = 0; l < p.owned; l++) {
+            uint u = p.global[l];
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                uint v = g.tgt[e];
+                if (part[v] == i) {
+                    p.tgt.push_back(local[v]);
+                } else {
+                    if (ghost[v] == NONE) {
+                        ghost[v] = p.global.size();
+                        p.global.push_back(v);
+                        p.owner.push_back(part[v]);
+                    }
+                    p.tgt.push_back(ghost[v]);
+                }
+                p.wt.push_back(g.weight(e));
+            }
+            p.off[l + 1] = p.tgt.size();
+        }
+        for (uint x = p.owned; x < p.global.size(); x++) ghost[p.global[x]] = NONE;
+    }
+}
+
+// Den Graphen g gemäß part in k Teile aufteilen und Teil i in die Datei
+// prefix.i schreiben.
+// Resultatwert false bei einem Schreibfehler.
+template <typename V>
+bool writeParts (const FrozenGraph<V>& g, const vector<uint>& part, uint k,
+                 const string& prefix) {
+    vector<GraphPart> parts;
+    split(g, part, k, parts);
+    for (uint i = 0; i < k; i++) {
+        if (!parts[i].save((prefix + "." + to_string(i)).c_str())) return false;
+    }
+    return true;
+}
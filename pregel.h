@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "bitset.h"
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Knotenzentrierte Berechnungen (Pregel)
+ */
+
+// Kombinierer für Pregel: Zwei Nachrichten an denselben Knoten werden
+// zu einer zusammengefasst (Minimum bzw. Summe).
+struct MinCombiner {
+    template <typename M>
+    M operator() (const M& a, const M& b) const { return min(a, b); }
+};
+
+struct SumCombiner {
+    template <typename M>
+    M operator() (const M& a, const M& b) const { return a + b; }
+};
+
+// Rahmen für knotenzentrierte Berechnungen in Superschritten
+// (bulk-synchronous parallel) mit Zustand S je Knoten, Nachrichten vom
+// Typ M und Kombinierer C.
+// In jedem Superschritt wird die Funktion compute für jeden aktiven
+// Knoten aufgerufen. Sie sieht den eigenen Zustand und die (bereits
+// kombinierte) Nachricht aus dem vorigen Superschritt, kann Nachrichten
+// an beliebige Knoten senden, die erst im nächsten Superschritt
+// ankommen, und sich schlafen legen (voteToHalt). Ein schlafender
+// Knoten wird durch eine Nachricht wieder aktiv. Die Berechnung endet,
+// wenn alle Knoten schlafen und keine Nachrichten unterwegs sind.
+// Aktive Knoten werden in Bitfeldern verwaltet; die Knoten eines
+// 64-Bit-Worts bearbeitet immer derselbe Thread, sodass die Bitfelder
+// ohne Synchronisation geschrieben werden können. Die Nachrichten liegen
+// in zwei Feldern (ein Eintrag je Knoten), die nach jedem Superschritt
+// getauscht werden; gleichzeitiges Senden an Knoten desselben Worts ist
+// durch eine von STRIPES Sperren geschützt.
+// (S darf nicht bool sein, weil vector<bool> keine unabhängig
+// schreibbaren Einträge hat.)
+template <typename S, typename M, typename C>
+struct Pregel {
+    static constexpr uint STRIPES = 1024;
+
+    // Sicht von compute auf den Knoten id.
+    struct Vertex {
+        Pregel& p;
+        uint id, worker;
+        bool halt;
+
+        // Nummer des aktuellen Superschritts (ab 0).
+        uint superstep () const { return p.step; }
+
+        // Zustand des Knotens.
+        S& value () { return p.value[id]; }
+
+        // Liegt eine Nachricht vor, und welche?
+        bool hasMessage () const { return p.got.test(id); }
+        const M& message () const { return p.inbox[id]; }
+
+        // Nachricht m an den Knoten w senden.
+        void send (uint w, const M& m) { p.deliver(w, m); }
+
+        // Knoten nach diesem Superschritt schlafen legen.
+        void voteToHalt () { halt = true; }
+
+        // x zur Summe addieren, die im nächsten Superschritt als
+        // aggregated() sichtbar ist.
+        void aggregate (double x) { p.partial[worker] += x; }
+        double aggregated () const { return p.aggregated; }
+    };
+
+    vector<S> value;
+    vector<M> inbox, outbox;
+    Bitset got, sent, halted;
+    C combine;
+    unique_ptr<mutex[]> locks;
+    vector<double> partial;
+    double aggregated = 0;
+    uint step = 0;
+
+    // Rahmen für n Knoten mit Anfangszustand init erzeugen.
+    Pregel (uint n, const S& init, C c = C())
+        : value(n, init), inbox(n), outbox(n), got(n), sent(n), halted(n),
+          combine(c), locks(new mutex[STRIPES]) {}
+
+    // Nachricht m für den nächsten Superschritt bei w ablegen bzw. mit
+    // einer schon vorliegenden kombinieren.
+    void deliver (uint w, const M& m) {
+        lock_guard<mutex> lock(locks[(w >> 6) % STRIPES]);
+        if (sent.test(w)) {
+            outbox[w] = combine(outbox[w], m);
+        } else {
+            outbox[w] = m;
+            sent.set(w);
+        }
+    }
+
+    // Aktive Knoten im Wort i (wache oder mit Nachricht).
+    uint64_t active (size_t i) const {
+        uint64_t a = ~halted.words[i] | got.words[i];
+        uint rest = value.size() % 64;
+        if (i + 1 == halted.words.size() && rest) a &= (uint64_t(1) << rest) - 1;
+        return a;
+    }
+
+    // Superschritte mit compute(Vertex&) auf den Threads von pool
+    // ausführen, bis kein Knoten mehr aktiv ist, höchstens aber bis
+    // Superschritt maxSteps. Resultatwert: Anzahl der ausgeführten
+    // Superschritte (insgesamt, auch über mehrere Aufrufe).
+    template <typename F>
+    uint run (F compute, uint maxSteps = NONE, ThreadPool& pool = defaultPool()) {
+        size_t words = halted.words.size();
+        partial.assign(pool.size(), 0);
+        for (; step < maxSteps; step++) {
+            bool any = false;
+            for (size_t i = 0; i < words && !any; i++) any = active(i) != 0;
+            if (!any) break;
+
+            fill(partial.begin(), partial.end(), 0);
+            pool.parallelFor(words, [&] (size_t i, uint w) {
+                uint64_t a = active(i), h = halted.words[i];
+                while (a) {
+                    uint b = __builtin_ctzll(a);
+                    a &= a - 1;
+                    Vertex x{ *this, uint(i * 64 + b), w, false };
+                    compute(x);
+                    if (x.halt) h |= uint64_t(1) << b;
+                    else h &= ~(uint64_t(1) << b);
+                }
+                halted.words[i] = h;
+                got.words[i] = 0;
+            }, 16);
+
+            aggregated = 0;
+            for (double x : partial) aggregated += x;
+            inbox.swap(outbox);
+            got.words.swap(sent.words);
+        }
+        return step;
+    }
+};
+
+/*
+ *  Algorithmen als Knotenprogramme
+ */
+
+// Breitensuche im Graphen g mit Startknoten s (Index): dist[v] ist
+// danach die Anzahl der Kanten eines kürzesten Weges von s nach v
+// (NONE, wenn v nicht erreichbar ist). Jeder Superschritt bearbeitet
+// eine Ebene.
+template <typename V>
+void pregelBfs (const FrozenGraph<V>& g, uint s, vector<uint>& dist,
+                ThreadPool& pool = defaultPool()) {
+    Pregel<uint, uint, MinCombiner> p(g.size(), NONE);
+    p.run([&] (Pregel<uint, uint, MinCombiner>::Vertex& x) {
+        uint d = x.superstep() == 0 ? (x.id == s ? 0 : NONE) : x.message();
+        if (d < x.value()) {
+            x.value() = d;
+            for (uint e = g.off[x.id]; e < g.off[x.id + 1]; e++) {
+                x.send(g.tgt[e], d + 1);
+            }
+        }
+        x.voteToHalt();
+    }, NONE, pool);
+    dist.swap(p.value);
+}
+
+// Kürzeste Wege vom Startknoten s (Index) im Graphen g (nicht negative
+// Gewichte) wie bei Bellman-Ford: Ein Knoten, dessen Distanz sinkt,
+// schickt die neuen Distanzen an seine Nachfolger. dist[v] ist danach
+// die Distanz von s nach v (unendlich, wenn v nicht erreichbar ist).
+template <typename V>
+void pregelSssp (const FrozenGraph<V>& g, uint s, vector<double>& dist,
+                 ThreadPool& pool = defaultPool()) {
+    const double inf = numeric_limits<double>::infinity();
+    Pregel<double, double, MinCombiner> p(g.size(), inf);
+    p.run([&] (Pregel<double, double, MinCombiner>::Vertex& x) {
+        double d = x.superstep() == 0 ? (x.id == s ? 0 : inf) : x.message();
+        if (d < x.value()) {
+            x.value() = d;
+            for (uint e = g.off[x.id]; e < g.off[x.id + 1]; e++) {
+                x.send(g.tgt[e], d + g.weight(e));
+            }
+        }
+        x.voteToHalt();
+    }, NONE, pool);
+    dist.swap(p.value);
+}
+
+// PageRank aller Knoten des Graphen g mit iterations Iterationen und
+// Dämpfungsfaktor damping (wie pagerank in centrality.h ohne
+// Teleportationsmenge und Abbruchschranke). Jeder Knoten schickt
+// rank / outdeg an seine Nachfolger; der Rang der Knoten ohne
+// Nachfolger wird über aggregate summiert und im nächsten
+// Superschritt gleichmäßig verteilt.
+template <typename V>
+void pregelPageRank (const FrozenGraph<V>& g, vector<double>& rank,
+                     uint iterations, double damping = 0.85,
+                     ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    Pregel<double, double, SumCombiner> p(n, n ? 1.0 / n : 0);
+    p.run([&] (Pregel<double, double, SumCombiner>::Vertex& x) {
+        if (x.superstep() > 0) {
+            double sum = x.hasMessage() ? x.message() : 0;
+            x.value() = (1 - damping + damping * x.aggregated()) / n
+                        + damping * sum;
+        }
+        if (x.superstep() == iterations) {
+            x.voteToHalt();
+            return;
+        }
+        uint deg = g.off[x.id + 1] - g.off[x.id];
+        if (deg == 0) x.aggregate(x.value());
+        for (uint e = g.off[x.id]; e < g.off[x.id + 1]; e++) {
+            x.send(g.tgt[e], x.value() / deg);
+        }
+    }, iterations + 1, pool);
+    rank.swap(p.value);
+}
+
+// Zusammenhangskomponenten des ungerichteten Graphen g (jede Kante in
+// beiden Richtungen vorhanden) durch Weitergeben der kleinsten Marke:
+// labels[v] ist danach der kleinste Index in der Komponente von v.
+// Resultatwert: Anzahl der Komponenten.
+template <typename V>
+uint pregelComponents (const FrozenGraph<V>& g, vector<uint>& labels,
+                       ThreadPool& pool = defaultPool()) {
+    Pregel<uint, uint, MinCombiner> p(g.size(), NONE);
+    p.run([&] (Pregel<uint, uint, MinCombiner>::Vertex& x) {
+        uint l = x.superstep() == 0 ? x.id : x.message();
+        if (l < x.value()) {
+            x.value() = l;
+            for (uint e = g.off[x.id]; e < g.off[x.id + 1]; e++) {
+                if (g.tgt[e] > l) x.send(g.tgt[e], l);
+            }
+        }
+        x.voteToHalt();
+    }, NONE, pool);
+    labels.swap(p.value);
+    uint count = 0;
+    for (uint v = 0; v < labels.size(); v++) {
+        if (labels[v] == v) count++;
+    }
+    return count;
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <set>
 
 // Eintrag einer Vorrangwarteschlange, bestehend aus einer Priorität
@@ -20,14 +22,19 @@ struct Entry {
 // An der Stelle, an der PrioQueue für einen bestimmten Typ P verwendet
 // wird, muss ein Kleiner-Operator (<) für den Typ P bekannt sein.
 // Andere Vergleichsoperatoren (<=, >, >=, ==, !=) werden nicht benötigt.
-template <typename P, typename D>
+// Mit Max gleich true ist es eine Maximum-Vorrangwarteschlange:
+// minimum und extractMinimum liefern dann den Eintrag mit maximaler
+// Priorität (etwa für Wege mit maximaler Engstelle, siehe widest.h).
+template <typename P, typename D, bool Max = false>
 struct PrioQueue {
     using Entry = ::Entry<P, D>;
 
     struct LessThan {
         bool operator() (Entry* e1, Entry* e2) const {
-            if (e1->prio < e2->prio) return true;
-            if (e2->prio < e1->prio) return false;
+            const P& p1 = Max ? e2->prio : e1->prio;
+            const P& p2 = Max ? e1->prio : e2->prio;
+            if (p1 < p2) return true;
+            if (p2 < p1) return false;
             return e1 < e2;
         }
     };
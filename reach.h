@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "components.h"
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Erreichbarkeitsindex (transitive Hülle als Bitmengen)
+ */
+
+// Index für Anfragen "Ist v von u aus erreichbar?" auf einem beliebigen
+// gerichteten Graphen.
+// Alle Knoten einer starken Zusammenhangskomponente erreichen sich
+// gegenseitig; der Index speichert daher für jede Komponente c die
+// Bitmenge der von c aus erreichbaren Komponenten (einschließlich c).
+// Die Bitmengen werden entweder dicht (eine Zeile mit words Wörtern je
+// Komponente, Anfrage O(1)) oder komprimiert gespeichert (nur die
+// Wörter ungleich 0 einer Zeile mit ihrer Wortnummer, Anfrage durch
+// binäre Suche in der Zeile).
+// Zusätzlich erhält jede Komponente eine Ebene (Länge des längsten
+// Weges zu einer Senke im Komponentengraphen): Weil jede Kante zu
+// einer niedrigeren Ebene führt, sind Anfragen mit level[cu] <=
+// level[cv] (und cu != cv) ohne Blick auf die Bitmengen negativ.
+struct ReachIndex {
+    vector<uint> comp, level;
+    uint count = 0, words = 0;
+    bool dense = true;
+
+    // Dichte Darstellung: Zeile c steht in bits ab c * words.
+    vector<uint64_t> bits;
+
+    // Komprimierte Darstellung: Zeile c besteht aus den Einträgen
+    // rowOff[c] bis rowOff[c + 1] - 1 von widx (Wortnummern,
+    // aufsteigend) und wbits (Wörter).
+    vector<size_t> rowOff;
+    vector<uint> widx;
+    vector<uint64_t> wbits;
+
+    // Ist der Knoten v (Index) vom Knoten u (Index) aus erreichbar?
+    bool reachable (uint u, uint v) const {
+        uint cu = comp[u], cv = comp[v];
+        if (cu == cv) return true;
+        if (level[cu] <= level[cv]) return false;
+        uint w = cv >> 6;
+        uint64_t bit = uint64_t(1) << (cv & 63);
+        if (dense) return bits[size_t(cu) * words + w] & bit;
+        auto b = widx.begin() + rowOff[cu], e = widx.begin() + rowOff[cu + 1];
+        auto it = lower_bound(b, e, w);
+        return it != e && *it == w && (wbits[it - widx.begin()] & bit);
+    }
+};
+
+// Erreichbarkeitsindex für den Graphen g aufbauen und in idx speichern.
+// Ablauf:
+// 1. Starke Zusammenhangskomponenten (scc auf dem eingefrorenen Graphen,
+//    die Nummerierung ist bereits eine umgekehrte topologische
+//    Sortierung) und Kanten des Komponentengraphen ermitteln.
+// 2. Ebenen bestimmen und Komponenten nach Ebenen gruppieren.
+// 3. Die Bitmengen spaltenweise in Stücken von chunkWords Wörtern
+//    berechnen: Ebene für Ebene (ab den Senken) ist die Zeile einer
+//    Komponente die wortweise Vereinigung der Zeilen ihrer Nachfolger
+//    plus ihr eigenes Bit. Alle Komponenten einer Ebene hängen nur von
+//    niedrigeren Ebenen ab und werden parallel berechnet.
+//    Pro Stück wird nur Speicher für count * chunkWords Wörter benötigt.
+// 4. Passt die dichte Matrix in denseLimit Bytes, wird sie direkt
+//    behalten; andernfalls wird jedes Stück nach seiner Berechnung
+//    komprimiert.
+template <typename V>
+void buildReach (const FrozenGraph<V>& g, ReachIndex& idx,
+                 ThreadPool& pool = defaultPool(),
+                 size_t denseLimit = size_t(1) << 28,
+                 uint chunkWords = 1024) {
+    uint c = idx.count = scc(g, idx.comp);
+    uint words = idx.words = (c + 63) / 64;
+
+    // Komponentengraph (ohne Mehrfachkanten).
+    vector<uint> coff(c + 1, 0), ctgt;
+    {
+        vector<vector<uint>> succ(c);
+        for (uint u = 0; u < g.size(); u++) {
+            for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+                uint a = idx.comp[u], b = idx.comp[g.tgt[e]];
+                if (a != b) succ[a].push_back(b);
+            }
+        }
+        for (uint a = 0; a < c; a++) {
+            sort(succ[a].begin(), succ[a].end());
+            succ[a].erase(unique(succ[a].begin(), succ[a].end()),
+                          succ[a].end());
+            coff[a + 1] = coff[a] + succ[a].size();
+            ctgt.insert(ctgt.end(), succ[a].begin(), succ[a].end());
+        }
+    }
+
+    // Ebenen (Nachfolger haben kleinere Nummern und sind daher schon
+    // bearbeitet).
+    idx.level.assign(c, 0);
+    uint maxLevel = 0;
+    for (uint a = 0; a < c; a++) {
+        for (uint x = coff[a]; x < coff[a + 1]; x++) {
+            idx.level[a] = max(idx.level[a], idx.level[ctgt[x]] + 1);
+        }
+        maxLevel = max(maxLevel, idx.level[a]);
+    }
+    vector<vector<uint>> byLevel(c ? maxLevel + 1 : 0);
+    for (uint a = 0; a < c; a++) byLevel[idx.level[a]].push_back(a);
+
+    idx.dense = size_t(c) * words * sizeof(uint64_t) <= denseLimit;
+    uint chunk = idx.dense ? max(words, 1u) : max(chunkWords, 1u);
+    vector<uint64_t> buf;
+    vector<vector<pair<uint, uint64_t>>> rows(idx.dense ? 0 : c);
+
+    for (uint w0 = 0; w0 < words; w0 += chunk) {
+        uint cw = min(chunk, words - w0);
+        buf.assign(size_t(c) * cw, 0);
+        for (auto& lv : byLevel) {
+            pool.parallelFor(lv.size(), [&] (size_t i, uint) {
+                uint a = lv[i];
+                uint64_t* row = &buf[size_t(a) * cw];
+                if (a / 64 >= w0 && a / 64 < w0 + cw) {
+                    row[a / 64 - w0] |= uint64_t(1) << (a & 63);
+                }
+                for (uint x = coff[a]; x < coff[a + 1]; x++) {
+                    const uint64_t* s = &buf[size_t(ctgt[x]) * cw];
+                    for (uint j = 0; j < cw; j++) row[j] |= s[j];
+                }
+            }, 64);
+        }
+        if (idx.dense) break;
+
+        pool.parallelFor(c, [&] (size_t a, uint) {
+            const uint64_t* row = &buf[a * cw];
+            for (uint j = 0; j < cw; j++) {
+                if (row[j]) rows[a].push_back({ w0 + j, row[j] });
+            }
+        }, 256);
+    }
+
+    if (idx.dense) {
+        idx.bits.swap(buf);
+        return;
+    }
+    idx.rowOff.assign(c + 1, 0);
+    for (uint a = 0; a < c; a++) idx.rowOff[a + 1] = idx.rowOff[a] + rows[a].size();
+    idx.widx.resize(idx.rowOff[c]);
+    idx.wbits.resize(idx.rowOff[c]);
+    for (uint a = 0; a < c; a++) {
+        size_t k = idx.rowOff[a];
+        for (auto& p : rows[a]) {
+            idx.widx[k] = p.first;
+            idx.wbits[k++] = p.second;
+        }
+        vector<pair<uint, uint64_t>>().swap(rows[a]);
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "bitset.h"
+#include "csr.h"
+#include "threadpool.h"
+
+/*
+ *  Graphalgorithmen als lineare Algebra über Halbringen
+ */
+
+// Ein Schritt vieler Graphalgorithmen ist ein Produkt y = x A eines
+// Vektors mit der Adjazenzmatrix A (A[u][v] = Gewicht der Kante (u, v)),
+// bei dem Addition und Multiplikation durch die Operationen eines
+// Halbrings ersetzt sind: y[v] = add über alle Kanten (u, v) von
+// mul(x[u], w(u, v)).
+// Ein Halbring R definiert den Elementtyp T, das neutrale Element zero
+// von add (zugleich "kein Eintrag"), add und mul sowie full(a): true,
+// wenn add(a, b) für kein b mehr etwas an a ändert (dann kann die
+// Summe vorzeitig abgebrochen werden).
+
+// Boolescher Halbring (oder, und) für Erreichbarkeit und Breitensuche.
+// (uint8_t statt bool, damit vector<T> unabhängig schreibbare Einträge
+// hat.)
+struct OrAnd {
+    typedef uint8_t T;
+    static T zero () { return 0; }
+    static T add (T a, T b) { return a | b; }
+    static T mul (T a, double) { return a; }
+    static bool full (T a) { return a != 0; }
+};
+
+// Tropischer Halbring (min, +) für kürzeste Wege.
+struct MinPlus {
+    typedef double T;
+    static T zero () { return numeric_limits<double>::infinity(); }
+    static T add (T a, T b) { return min(a, b); }
+    static T mul (T a, double w) { return a + w; }
+    static bool full (T) { return false; }
+};
+
+// Gewöhnlicher Halbring (+, *) etwa für PageRank (mit den Beiträgen
+// rank[u] / outdeg(u) als Vektor).
+struct PlusTimes {
+    typedef double T;
+    static T zero () { return 0; }
+    static T add (T a, T b) { return a + b; }
+    static T mul (T a, double w) { return a * w; }
+    static bool full (T) { return false; }
+};
+
+// Dünn besetzter Vektor: Indizes und Werte der Einträge ungleich zero
+// (ohne bestimmte Reihenfolge).
+template <typename T>
+struct SparseVector {
+    vector<uint> idx;
+    vector<T> val;
+
+    size_t size () const { return idx.size(); }
+    bool empty () const { return idx.empty(); }
+    void clear () {
+        idx.clear();
+        val.clear();
+    }
+    void push (uint i, T x) {
+        idx.push_back(i);
+        val.push_back(x);
+    }
+};
+
+// Maske für das Ergebnis eines Produkts: Nur Einträge v, für die
+// bits->test(v) != complement gilt, werden berechnet (ohne bits: alle).
+// Mit complement = true und den schon besuchten Knoten als bits
+// berechnet die Breitensuche nur noch unbesuchte Knoten.
+struct Mask {
+    const Bitset* bits = nullptr;
+    bool complement = false;
+
+    Mask () {}
+    Mask (const Bitset& b, bool c) : bits(&b), complement(c) {}
+
+    bool allows (uint v) const { return !bits || bits->test(v) != complement; }
+};
+
+// Arbeitsspeicher für Produkte mit n Knoten: dichte Felder für Ein- und
+// Ausgabe sowie Markierungen der schon belegten Einträge.
+template <typename T>
+struct SemiringSpace {
+    vector<T> in, out;
+    Bitset seen;
+};
+
+// Push-Richtung: y = x A für einen dünn besetzten Vektor x
+// (sparse matrix - sparse vector). Es werden nur die Kanten der
+// Einträge von x durchlaufen; die Summen entstehen in sp.out, belegte
+// Einträge werden in sp.seen markiert.
+template <typename R, typename V>
+void spmspv (const FrozenGraph<V>& g, const SparseVector<typename R::T>& x,
+             SparseVector<typename R::T>& y, const Mask& mask,
+             SemiringSpace<typename R::T>& sp) {
+    uint n = g.size();
+    if (sp.out.size() != n) sp.out.assign(n, R::zero());
+    if (sp.seen.words.size() != (size_t(n) + 63) / 64) sp.seen.assign(n);
+    y.clear();
+    for (size_t i = 0; i < x.size(); i++) {
+        uint u = x.idx[i];
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            uint v = g.tgt[e];
+            if (!mask.allows(v)) continue;
+            auto p = R::mul(x.val[i], g.weight(e));
+            if (sp.seen.test(v)) {
+                sp.out[v] = R::add(sp.out[v], p);
+            } else {
+                sp.seen.set(v);
+                sp.out[v] = p;
+                y.idx.push_back(v);
+            }
+        }
+    }
+    y.val.resize(y.idx.size());
+    for (size_t i = 0; i < y.size(); i++) {
+        uint v = y.idx[i];
+        y.val[i] = sp.out[v];
+        sp.seen.reset(v);
+    }
+}
+
+// Pull-Richtung: y = x A für einen dichten Vektor x (sparse matrix -
+// dense vector) über den transponierten Graphen t: Jeder Eintrag y[v]
+// sammelt über die Vorgänger von v und wird nur von einem Thread
+// geschrieben, sodass die Einträge ohne Synchronisation auf die Threads
+// von pool verteilt werden können. Sobald R::full(y[v]) gilt, werden die
+// übrigen Vorgänger übersprungen. Maskierte Einträge sind zero.
+template <typename R, typename V>
+void spmv (const FrozenGraph<V>& t, const vector<typename R::T>& x,
+           vector<typename R::T>& y, const Mask& mask,
+           ThreadPool& pool = defaultPool()) {
+    uint n = t.size();
+    y.resize(n);
+    pool.parallelRange(n, [&] (size_t b, size_t e, uint) {
+        for (size_t v = b; v < e; v++) {
+            auto s = R::zero();
+            if (mask.allows(v)) {
+                for (uint k = t.off[v]; k < t.off[v + 1]; k++) {
+                    auto a = x[t.tgt[k]];
+                    if (a == R::zero()) continue;
+                    s = R::add(s, R::mul(a, t.weight(k)));
+                    if (R::full(s)) break;
+                }
+            }
+            y[v] = s;
+        }
+    }, 1024);
+}
+
+// Anteil der Kanten, ab dem vxm in Pull-Richtung rechnet: Push, solange
+// die Einträge von x zusammen weniger als edges() / PULL_RATIO Kanten
+// besitzen (wie bei richtungsoptimierter Breitensuche).
+constexpr uint PULL_RATIO = 16;
+
+// y = x A mit Maske für einen dünn besetzten Vektor x, wahlweise mit
+// spmspv (wenige Kanten betroffen, sequenziell) oder spmv (viele Kanten,
+// parallel); t ist der transponierte Graph von g.
+template <typename R, typename V>
+void vxm (const FrozenGraph<V>& g, const FrozenGraph<V>& t,
+          const SparseVector<typename R::T>& x, SparseVector<typename R::T>& y,
+          const Mask& mask, SemiringSpace<typename R::T>& sp,
+          ThreadPool& pool = defaultPool()) {
+    size_t work = 0;
+    for (uint u : x.idx) work += g.off[u + 1] - g.off[u];
+    if (work * PULL_RATIO < g.edges()) {
+        spmspv<R>(g, x, y, mask, sp);
+        return;
+    }
+
+    uint n = g.size();
+    sp.in.assign(n, R::zero());
+    for (size_t i = 0; i < x.size(); i++) sp.in[x.idx[i]] = x.val[i];
+    spmv<R>(t, sp.in, sp.out, mask, pool);
+    y.clear();
+    for (uint v = 0; v < n; v++) {
+        if (sp.out[v] != R::zero()) y.push(v, sp.out[v]);
+    }
+}
+
+/*
+ *  Algorithmen als Halbring-Produkte
+ */
+
+// Breitensuche im Graphen g (t = transponierter Graph) mit Startknoten s
+// (Index) als Folge von Produkten über (oder, und): Die nächste Ebene
+// ist frontier A, maskiert mit dem Komplement der besuchten Knoten.
+// dist[v] ist danach die Ebene von v (NONE, wenn nicht erreichbar).
+template <typename V>
+void bfsSemiring (const FrozenGraph<V>& g, const FrozenGraph<V>& t, uint s,
+                  vector<uint>& dist, ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    dist.assign(n, NONE);
+    Bitset visited(n);
+    SemiringSpace<OrAnd::T> sp;
+    SparseVector<OrAnd::T> x, y;
+    dist[s] = 0;
+    visited.set(s);
+    x.push(s, 1);
+    for (uint d = 1; !x.empty(); d++) {
+        vxm<OrAnd>(g, t, x, y, Mask(visited, true), sp, pool);
+        for (uint v : y.idx) {
+            dist[v] = d;
+            visited.set(v);
+        }
+        x.idx.swap(y.idx);
+        x.val.swap(y.val);
+    }
+}
+
+// Kürzeste Wege vom Startknoten s (Index) im Graphen g (t =
+// transponierter Graph) mit Bellman-Ford als Folge von Produkten über
+// (min, +): Nur die in der letzten Runde verbesserten Knoten bilden den
+// nächsten Vektor. dist[v] ist danach die Distanz von s nach v.
+// Resultatwert true, wenn es keinen von s aus erreichbaren Zyklus mit
+// negativem Gewicht gibt, andernfalls false (wie bellmanFord; dist ist
+// dann undefiniert).
+template <typename V>
+bool bellmanFordSemiring (const FrozenGraph<V>& g, const FrozenGraph<V>& t,
+                          uint s, vector<double>& dist,
+                          ThreadPool& pool = defaultPool()) {
+    uint n = g.size();
+    dist.assign(n, MinPlus::zero());
+    SemiringSpace<MinPlus::T> sp;
+    SparseVector<MinPlus::T> x, y;
+    dist[s] = 0;
+    x.push(s, 0);
+    for (uint round = 0; round < n; round++) {
+        vxm<MinPlus>(g, t, x, y, Mask(), sp, pool);
+        x.clear();
+        for (size_t i = 0; i < y.size(); i++) {
+            uint v = y.idx[i];
+            if (y.val[i] < dist[v]) {
+                dist[v] = y.val[i];
+                x.push(v, y.val[i]);
+            }
+        }
+        if (x.empty()) return true;
+    }
+    return false;
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "csr.h"
+
+/*
+ *  Binäres Anfrage-/Antwortprotokoll des Abfrageservers
+ */
+
+// Art einer Anfrage: kürzester Weg (Dijkstra), Weg mit minimaler
+// Kantenzahl (Breitensuche) oder reine Erreichbarkeit.
+enum Op : uint32_t { OP_SP = 1, OP_BFS = 2, OP_REACH = 3 };
+
+// Status einer Antwort.
+enum Status : uint32_t { ST_OK = 0, ST_UNREACHABLE = 1, ST_INVALID = 2 };
+
+// Anfrage mit Start- und Zielknoten (als Knotenwerte, nicht Indizes).
+struct Request {
+    uint32_t op, s, t;
+};
+
+// Antwort mit Distanz und Länge des Weges. Bei OP_SP und OP_BFS folgen
+// direkt danach len Knoten des Weges als uint32_t (einschließlich Start-
+// und Zielknoten), bei OP_REACH ist len immer 0.
+struct Response {
+    uint32_t status, len;
+    double dist;
+};
+
+// Genau n Bytes vom bzw. zum Dateideskriptor fd übertragen.
+// Resultatwert false bei Dateiende oder Fehler.
+inline bool readFull (int fd, void* buf, size_t n) {
+    char* p = static_cast<char*>(buf);
+    while (n > 0) {
+        ssize_t k = read(fd, p, n);
+        if (k <= 0) return false;
+        p += k;
+        n -= k;
+    }
+    return true;
+}
+
+inline bool writeFull (int fd, const void* buf, size_t n) {
+    const char* p = static_cast<const char*>(buf);
+    while (n > 0) {
+        ssize_t k = write(fd, p, n);
+        if (k <= 0) return false;
+        p += k;
+        n -= k;
+    }
+    return true;
+}
+
+// Adresse eines Unix-Domain-Sockets mit Pfad path füllen.
+inline bool socketAddress (const char* path, sockaddr_un& addr) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return false;
+    strcpy(addr.sun_path, path);
+    return true;
+}
+
+/*
+ *  Server
+ */
+
+// Anfrage req auf dem Graphen g mit dem Arbeitsspeicher ws beantworten
+// und den Weg (als Knotenwerte) in p speichern.
+// Mit einem Zwischenspeicher cache wird der vollständige Baum des
+// Startknotens verwendet bzw. berechnet und aufgenommen, sodass
+// weitere Anfragen mit demselben Startknoten ohne Suche auskommen.
+inline Response answer (const FrozenGraph<uint>& g, const Request& req,
+                        Workspace& ws, vector<uint32_t>& p,
+                        TreeCache* cache = nullptr) {
+    Response res = { ST_INVALID, 0, 0 };
+    p.clear();
+    uint s = g.index(req.s), t = g.index(req.t);
+    if (s == NONE || t == NONE) return res;
+    if (req.op < OP_SP || req.op > OP_REACH) return res;
+
+    if (cache) {
+        // Der Graph des Servers ist unveränderlich (Version 0).
+        auto tree = cache->tree(g, 0, s, req.op != OP_SP, ws);
+        if (!tree->reached(t)) {
+            res.status = ST_UNREACHABLE;
+            res.dist = numeric_limits<double>::infinity();
+            return res;
+        }
+        res.status = ST_OK;
+        res.dist = tree->distance(t);
+        if (req.op != OP_REACH) {
+            tree->path(t, p);
+            for (auto& v : p) v = g.vertex(v);
+            res.len = p.size();
+        }
+        return res;
+    }
+
+    switch (req.op) {
+    case OP_SP: dijkstra(g, s, ws, t); break;
+    case OP_BFS: case OP_REACH: bfs(g, s, ws, t); break;
+    default: return res;
+    }
+
+    res.dist = ws.distance(t);
+    if (!ws.seen(t)) {
+        res.status = ST_UNREACHABLE;
+        return res;
+    }
+    res.status = ST_OK;
+    if (req.op != OP_REACH) {
+        ws.path(t, p);
+        for (auto& v : p) v = g.vertex(v);
+        res.len = p.size();
+    }
+    return res;
+}
+
+// Eine Anfrage der Verbindung fd lesen und beantworten.
+// Antwortkopf und Weg werden im Puffer out zusammengesetzt und mit
+// einem einzigen Systemaufruf verschickt.
+// Resultatwert false, wenn der Client die Verbindung geschlossen hat
+// oder die Übertragung fehlschlägt.
+inline bool serveRequest (const FrozenGraph<uint>& g, int fd,
+                          Workspace& ws, vector<uint32_t>& p,
+                          vector<char>& out, TreeCache* cache = nullptr) {
+    Request req;
+    if (!readFull(fd, &req, sizeof(req))) return false;
+    Response res = answer(g, req, ws, p, cache);
+    out.resize(sizeof(res) + p.size() * sizeof(uint32_t));
+    memcpy(out.data(), &res, sizeof(res));
+    if (!p.empty()) {
+        memcpy(out.data() + sizeof(res), p.data(),
+               p.size() * sizeof(uint32_t));
+    }
+    return writeFull(fd, out.data(), out.size());
+}
+
+// Wartezeit in Millisekunden, bevor nach einem fehlgeschlagenen accept
+// (etwa weil keine Dateideskriptoren mehr frei sind) wieder
+// Verbindungen angenommen werden.
+const int ACCEPT_PAUSE = 100;
+
+// Den Graphen g über einen Unix-Domain-Socket mit Pfad path mit
+// threads Arbeitsthreads bereitstellen.
+// Der aufrufende Thread nimmt die Verbindungen an und wartet mit poll
+// auf allen gerade unbeschäftigten Verbindungen auf die nächste
+// Anfrage. Trifft eine ein, kommt die Verbindung in die Warteschlange;
+// ein freier Arbeitsthread beantwortet genau diese eine Anfrage und
+// gibt die Verbindung danach über eine Pipe zurück. Untätige Clients
+// binden damit keinen Arbeitsthread, und die Anfragen aller
+// Verbindungen verteilen sich einzeln auf die Threads. Jeder
+// Arbeitsthread besitzt einen eigenen, über alle seine Anfragen hinweg
+// wiederverwendeten Arbeitsspeicher.
+// Mit cacheBytes > 0 teilen sich alle Arbeitsthreads einen
+// Zwischenspeicher dieser Größe für die Bäume der Startknoten.
+// Kehrt nur bei einem Fehler beim Einrichten des Sockets zurück
+// (Resultatwert false).
+inline bool serve (const FrozenGraph<uint>& g, const char* path,
+                   uint threads, size_t cacheBytes = 0) {
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) return false;
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) return false;
+    unlink(path);
+    int back [2];
+    if (bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+            || listen(lfd, 128) < 0 || pipe(back) < 0) {
+        close(lfd);
+        return false;
+    }
+    // accept soll nach poll nicht blockieren, falls der Client die
+    // Verbindung inzwischen wieder abgebrochen hat.
+    fcntl(lfd, F_SETFL, fcntl(lfd, F_GETFL) | O_NONBLOCK);
+    // Von Clients geschlossene Verbindungen nicht als Signal, sondern
+    // als Schreibfehler behandeln.
+    signal(SIGPIPE, SIG_IGN);
+
+    TreeCache trees(cacheBytes);
+    TreeCache* cache = cacheBytes > 0 ? &trees : nullptr;
+    // Verbindungen mit einer eingetroffenen Anfrage.
+    deque<int> ready;
+    mutex m;
+    condition_variable wake;
+    vector<thread> pool;
+    for (uint i = 0; i < max(threads, 1u); i++) {
+        pool.emplace_back([&, cache] {
+            Workspace ws;
+            vector<uint32_t> p;
+            vector<char> out;
+            for (;;) {
+                int fd;
+                {
+                    unique_lock<mutex> lock(m);
+                    wake.wait(lock, [&] { return !ready.empty(); });
+                    fd = ready.front();
+                    ready.pop_front();
+                }
+                // (Schreibvorgänge bis PIPE_BUF Bytes sind atomar.)
+                if (!serveRequest(g, fd, ws, p, out, cache)
+                        || !writeFull(back[1], &fd, sizeof(fd))) {
+                    close(fd);
+                }
+            }
+        });
+    }
+
+    // Unbeschäftigte Verbindungen; fds[0] ist die Pipe, fds[1] der
+    // Socket (fd -1, solange keine Verbindungen angenommen werden).
+    vector<int> idle;
+    vector<pollfd> fds;
+    auto resume = chrono::steady_clock::now();
+    for (;;) {
+        auto now = chrono::steady_clock::now();
+        bool accepting = now >= resume;
+        fds.clear();
+        fds.push_back({ back[0], POLLIN, 0 });
+        fds.push_back({ accepting ? lfd : -1, POLLIN, 0 });
+        for (int fd : idle) fds.push_back({ fd, POLLIN, 0 });
+        int timeout = accepting ? -1 : int(chrono::duration_cast<
+                chrono::milliseconds>(resume - now).count()) + 1;
+        if (poll(fds.data(), fds.size(), timeout) < 0) continue;
+
+        idle.clear();
+        bool queued = false;
+        {
+            lock_guard<mutex> lock(m);
+            for (size_t k = 2; k < fds.size(); k++) {
+                if (!fds[k].revents) idle.push_back(fds[k].fd);
+                else {
+                    ready.push_back(fds[k].fd);
+                    queued = true;
+                }
+            }
+        }
+        if (queued) wake.notify_all();
+
+        if (fds[0].revents & POLLIN) {
+            int done [64];
+            ssize_t n = read(back[0], done, sizeof(done));
+            for (ssize_t k = 0; k < n / ssize_t(sizeof(int)); k++) {
+                idle.push_back(done[k]);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            int fd = accept(lfd, nullptr, nullptr);
+            if (fd >= 0) idle.push_back(fd);
+            else if (errno != EINTR && errno != EAGAIN
+                     && errno != ECONNABORTED) {
+                cerr << "accept: " << strerror(errno) << endl;
+                resume = now + chrono::milliseconds(ACCEPT_PAUSE);
+            }
+        }
+    }
+}
+
+/*
+ *  Client
+ */
+
+// Verbindung zum Server mit Socketpfad path aufbauen.
+// Resultatwert: Dateideskriptor oder -1 bei einem Fehler.
+inline int connectServer (const char* path) {
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Anfrage req über die Verbindung fd stellen, die Antwort in res und
+// den Weg in p speichern.
+// Resultatwert false bei einem Übertragungsfehler.
+inline bool query (int fd, const Request& req, Response& res,
+                   vector<uint32_t>& p) {
+    if (!writeFull(fd, &req, sizeof(req))) return false;
+    if (!readFull(fd, &res, sizeof(res))) return false;
+    p.resize(res.len);
+    return readFull(fd, p.data(), p.size() * sizeof(uint32_t));
+}
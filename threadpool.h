@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "graph.h"
+
+// Pool von Arbeitsthreads für datenparallele Schleifen mit
+// Arbeitsaufteilung durch Stehlen (work stealing).
+// Der Indexbereich einer Schleife wird zunächst gleichmäßig auf die
+// Threads verteilt. Jeder Thread arbeitet seinen eigenen Bereich von
+// vorne in Stücken der Größe grain ab; ist er fertig, stiehlt er die
+// hintere Hälfte des größten noch offenen Bereichs eines anderen
+// Threads. Damit werden auch sehr ungleich teure Iterationen (etwa
+// Suchen von unterschiedlich gut vernetzten Startknoten aus) gut
+// ausgeglichen.
+// Der aufrufende Thread arbeitet als Thread 0 mit, sodass ein Pool mit
+// n Threads nur n - 1 zusätzliche Threads erzeugt.
+struct ThreadPool {
+    // Noch offener Indexbereich [begin, end) eines Threads.
+    struct Range {
+        mutex m;
+        size_t begin = 0, end = 0;
+    };
+
+    vector<thread> workers;
+    unique_ptr<Range[]> ranges;
+    uint n;
+
+    // Aktuelle Schleife: Rumpf, Stückgröße, Generationszähler (zum
+    // Aufwecken der Threads) und Anzahl noch arbeitender Threads.
+    function<void(size_t, size_t, uint)> body;
+    size_t grain = 1;
+    uint generation = 0;
+    uint running = 0;
+    bool quit = false;
+    exception_ptr error;
+    mutex m, busy;
+    condition_variable wake, done;
+
+    // Pool mit threads Threads (einschließlich des aufrufenden) erzeugen.
+    // (0 bedeutet: so viele, wie die Hardware gleichzeitig ausführen kann.)
+    explicit ThreadPool (uint threads = 0) {
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        n = threads;
+        ranges.reset(new Range[n]);
+        for (uint w = 1; w < n; w++) {
+            workers.emplace_back([this, w] { loop(w); });
+        }
+    }
+
+    ~ThreadPool () {
+        {
+            lock_guard<mutex> lock(m);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    // Anzahl der Threads (einschließlich des aufrufenden).
+    uint size () const { return n; }
+
+    // Thread w an den Prozessor cpus[w] binden. Thread 0 ist der
+    // aufrufende Thread, der damit ebenfalls gebunden wird.
+    // Weil jeder Thread zu Beginn einer Schleife den gleichen Teil des
+    // Indexbereichs erhält (count * w / n bis count * (w + 1) / n),
+    // greift er dann überwiegend auf Speicher zu, der seinem Prozessor
+    // nahe liegt, sofern die Felder entsprechend platziert sind (siehe
+    // numa.h).
+    // Resultatwert false, wenn das Betriebssystem eine Bindung ablehnt.
+    bool pin (const vector<uint>& cpus) {
+        bool ok = true;
+        for (uint w = 0; w < n && w < cpus.size(); w++) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[w], &set);
+            pthread_t t = w == 0 ? pthread_self() : workers[w - 1].native_handle();
+            ok = pthread_setaffinity_np(t, sizeof(set), &set) == 0 && ok;
+        }
+        return ok;
+    }
+
+    // f(i, w) für alle i von 0 bis count - 1 parallel ausführen, wobei w
+    // die Nummer (0 bis size() - 1) des ausführenden Threads ist.
+    // Die Funktion kehrt erst zurück, wenn alle Aufrufe beendet sind.
+    // Eine von f geworfene Ausnahme wird danach im aufrufenden Thread
+    // erneut geworfen.
+    // (Gleichzeitige Aufrufe aus mehreren Threads werden nacheinander
+    // ausgeführt; f selbst darf parallelFor desselben Pools nicht
+    // aufrufen.)
+    template <typename F>
+    void parallelFor (size_t count, F f, size_t grain = 1) {
+        parallelRange(count, [&f] (size_t b, size_t e, uint w) {
+            for (size_t i = b; i < e; i++) f(i, w);
+        }, grain);
+    }
+
+    // Wie parallelFor, aber f(b, e, w) erhält jeweils ein ganzes Stück
+    // [b, e) des Indexbereichs.
+    template <typename F>
+    void parallelRange (size_t count, F f, size_t grain = 1) {
+        if (count == 0) return;
+        lock_guard<mutex> call(busy);
+        if (n == 1 || count <= grain) {
+            f(0, count, 0);
+            return;
+        }
+        for (uint w = 0; w < n; w++) {
+            lock_guard<mutex> lock(ranges[w].m);
+            ranges[w].begin = count * w / n;
+            ranges[w].end = count * (w + 1) / n;
+        }
+        {
+            lock_guard<mutex> lock(m);
+            body = f;
+            this->grain = max<size_t>(grain, 1);
+            error = nullptr;
+            running = n;
+            generation++;
+        }
+        wake.notify_all();
+        work(0);
+
+        unique_lock<mutex> lock(m);
+        done.wait(lock, [this] { return running == 0; });
+        body = nullptr;
+        if (error) rethrow_exception(error);
+    }
+
+    // Hauptschleife eines zusätzlichen Threads w.
+    void loop (uint w) {
+        uint seen = 0;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+            work(w);
+        }
+    }
+
+    // Eigenen Bereich des Threads w abarbeiten und danach stehlen,
+    // solange es noch etwas zu stehlen gibt.
+    void work (uint w) {
+        size_t b, e;
+        while (take(w, b, e) || steal(w, b, e)) {
+            try {
+                body(b, e, w);
+            } catch (...) {
+                lock_guard<mutex> lock(m);
+                if (!error) error = current_exception();
+            }
+        }
+        lock_guard<mutex> lock(m);
+        if (--running == 0) done.notify_one();
+    }
+
+    // Nächstes Stück [b, e) vom Anfang des eigenen Bereichs nehmen.
+    bool take (uint w, size_t& b, size_t& e) {
+        Range& r = ranges[w];
+        lock_guard<mutex> lock(r.m);
+        if (r.begin >= r.end) return false;
+        b = r.begin;
+        e = min(r.end, b + grain);
+        r.begin = e;
+        return true;
+    }
+
+    // Hintere Hälfte des größten offenen Bereichs eines anderen Threads
+    // stehlen, zum eigenen Bereich machen und davon ein Stück nehmen.
+    bool steal (uint w, size_t& b, size_t& e) {
+        for (;;) {
+            uint victim = w;
+            size_t most = 0;
+            for (uint v = 0; v < n; v++) {
+                if (v == w) continue;
+                lock_guard<mutex> lock(ranges[v].m);
+                size_t left = ranges[v].end - ranges[v].begin;
+                if (left > most) {
+                    most = left;
+                    victim = v;
+                }
+            }
+            if (victim == w) return false;
+
+            size_t sb, se;
+            {
+                lock_guard<mutex> lock(ranges[victim].m);
+                Range& r = ranges[victim];
+                if (r.begin >= r.end) continue;
+                size_t mid = r.begin + (r.end - r.begin) / 2;
+                sb = mid;
+                se = r.end;
+                r.end = mid;
+            }
+            {
+                lock_guard<mutex> lock(ranges[w].m);
+                ranges[w].begin = sb;
+                ranges[w].end = se;
+            }
+            if (take(w, b, e)) return true;
+        }
+    }
+};
+
+// Einstellung für defaultPool(): Prozessoren, an die seine Threads bei
+// der Erzeugung gebunden werden (siehe ThreadPool::pin; voreingestellt
+// leer, also ungebunden). Wirkt nur, wenn sie vor dem ersten Aufruf
+// von defaultPool() gesetzt wird, z. B. mit pinDefaultPool (numa.h).
+inline vector<uint>& defaultPoolCpus () {
+    static vector<uint> cpus;
+    return cpus;
+}
+
+// Gemeinsamer Pool für Funktionen, denen kein eigener Pool übergeben
+// wird. (Wird beim ersten Aufruf mit der Hardware-Parallelität erzeugt
+// und gemäß defaultPoolCpus() gebunden; als Thread 0 wird dabei der
+// aufrufende Thread gebunden.)
+inline ThreadPool& defaultPool () {
+    static ThreadPool pool;
+    static bool pinned = defaultPoolCpus().empty()
+                         || pool.pin(defaultPoolCpus());
+    (void) pinned;
+    return pool;
+}
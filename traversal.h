@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <utility>	// pair
+#include <vector>
+
+#include "bitset.h"
+#include "csr.h"
+
+/*
+ *  Durchläufe mit Bitfeldern als Zustand
+ */
+
+// Die Tiefensuche auf Graph<V> hält für jeden Knoten Farbe,
+// Entdeckungs- und Abschlusszeit in Tabellen (map), auch wenn nur die
+// Reihenfolge (topsort) oder die Komponenten (scc) gebraucht werden.
+// Die folgenden Durchläufe arbeiten auf einem FrozenGraph und halten
+// den Zustand in Bitfeldern: 2 Bits je Knoten für die Farbe
+// (ColorMap) bzw. 1 Bit für "schon gesehen" (Bitset). det und fin
+// werden nur auf Wunsch erzeugt.
+
+// Was dfs auf einem FrozenGraph in DFS<V> eintragen soll
+// (Bitmaske): seq, det und fin, color_map.
+enum DfsOutput : uint { DFS_SEQ = 1, DFS_TIMES = 2, DFS_COLORS = 4 };
+
+// Keller der iterativen Tiefensuche: Knoten und Position der als
+// nächstes zu betrachtenden Kante.
+typedef vector<pair<uint, uint>> DfsStack;
+
+// Iterative Tiefensuche im Graphen g ab dem Knoten r (Index, muss WHITE
+// sein). discover(v) bzw. finish(v) wird aufgerufen, wenn v GRAY bzw.
+// BLACK wird.
+// Resultatwert false, wenn sorted gesetzt ist und ein GRAY-Knoten
+// erreicht wird (d. h. der Graph einen Zyklus enthält); die Suche wird
+// dann sofort abgebrochen.
+template <typename V, typename D, typename F>
+bool dfsFrom (const FrozenGraph<V>& g, uint r, ColorMap& color,
+              DfsStack& stack, bool sorted, D discover, F finish) {
+    color.set(r, DFS<V>::GRAY);
+    discover(r);
+    stack.push_back({ r, g.off[r] });
+    while (!stack.empty()) {
+        uint v = stack.back().first;
+        uint& e = stack.back().second;
+        if (e < g.off[v + 1]) {
+            uint w = g.tgt[e++];
+            uint c = color.get(w);
+            if (c == DFS<V>::WHITE) {
+                color.set(w, DFS<V>::GRAY);
+                discover(w);
+                stack.push_back({ w, g.off[w] });
+            } else if (c == DFS<V>::GRAY && sorted) {
+                stack.clear();
+                return false;
+            }
+            continue;
+        }
+        stack.pop_back();
+        color.set(v, DFS<V>::BLACK);
+        finish(v);
+    }
+    return true;
+}
+
+// Tiefensuche im Graphen g ausführen und alle Knoten (Indizes) nach
+// aufsteigenden Abschlusszeiten in seq speichern. Die Hauptschleife
+// durchläuft die Knoten nach aufsteigendem Index (wie dfs auf Graph<V>
+// in der Reihenfolge von g.vertices()).
+// Resultatwert false, wenn sorted gesetzt ist und der Graph einen
+// Zyklus enthält (seq ist dann unvollständig).
+template <typename V>
+bool dfs (const FrozenGraph<V>& g, vector<uint>& seq, bool sorted = false) {
+    ColorMap color(g.size());
+    DfsStack stack;
+    seq.clear();
+    seq.reserve(g.size());
+    for (uint r = 0; r < g.size(); r++) {
+        if (color.get(r) != DFS<V>::WHITE) continue;
+        if (!dfsFrom(g, r, color, stack, sorted, [] (uint) {},
+                     [&] (uint v) { seq.push_back(v); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tiefensuche im Graphen g ausführen und das Ergebnis in res speichern
+// (wie dfs auf Graph<V>, einschließlich res.sorted). out legt fest,
+// welche Teile von res gefüllt werden (siehe DfsOutput); ohne
+// DFS_TIMES und DFS_COLORS bleiben die Tabellen det, fin und color_map
+// leer und die Suche braucht je Knoten nur 2 Bits.
+// Resultatwert false, wenn res.sorted gesetzt ist und der Graph einen
+// Zyklus enthält (statt wie dfs auf Graph<V> false zu werfen).
+template <typename V>
+bool dfs (const FrozenGraph<V>& g, DFS<V>& res, uint out = DFS_SEQ) {
+    uint n = g.size(), time = 0;
+    vector<uint> det, fin;
+    if (out & DFS_TIMES) {
+        det.assign(n, 0);
+        fin.assign(n, 0);
+    }
+    ColorMap color(n);
+    DfsStack stack;
+    bool ok = true;
+    for (uint r = 0; r < n && ok; r++) {
+        if (color.get(r) != DFS<V>::WHITE) continue;
+        ok = dfsFrom(g, r, color, stack, res.sorted, [&] (uint v) {
+            if (out & DFS_TIMES) det[v] = ++time;
+        }, [&] (uint v) {
+            if (out & DFS_TIMES) fin[v] = ++time;
+            if (out & DFS_SEQ) res.seq.push_back(g.vs[v]);
+        });
+    }
+
+    for (uint v = 0; v < n; v++) {
+        if (out & DFS_TIMES) {
+            res.det[g.vs[v]] = det[v];
+            res.fin[g.vs[v]] = fin[v];
+        }
+        if (out & DFS_COLORS) {
+            res.color_map[g.vs[v]] = typename DFS<V>::color(color.get(v));
+        }
+    }
+    return ok;
+}
+
+// Topologische Sortierung des Graphen g ausführen und das Ergebnis
+// als Liste von Knoten in seq speichern (wie topsort auf Graph<V>,
+// also nach aufsteigenden Abschlusszeiten).
+// Resultatwert true, wenn dies möglich ist,
+// false, wenn der Graph einen Zyklus enthält.
+// (Im zweiten Fall darf der Inhalt von seq danach undefiniert sein.)
+template <typename V>
+bool topsort (const FrozenGraph<V>& g, list<V>& seq) {
+    vector<uint> order;
+    if (!dfs(g, order, true)) return false;
+    seq.clear();
+    for (uint v : order) seq.push_back(g.vs[v]);
+    return true;
+}
+
+// Breitensuche im Graphen g mit Startknoten s (Index), die nur ein Bit
+// je Knoten (seen) verwendet. order enthält danach alle erreichten
+// Knoten in der Reihenfolge ihrer Entdeckung; wenn levels angegeben
+// ist, steht darin für jede Distanz d die Position in order, ab der
+// die Knoten mit Distanz d stehen (und am Ende order.size()).
+// (Im Gegensatz zu bfs mit Workspace werden weder Distanzen noch
+// Vorgänger gespeichert.)
+template <typename V>
+void bfs (const FrozenGraph<V>& g, uint s, Bitset& seen, vector<uint>& order,
+          vector<uint>* levels = nullptr) {
+    seen.assign(g.size());
+    order.clear();
+    seen.set(s);
+    order.push_back(s);
+    if (levels) levels->assign(1, 0);
+
+    size_t end = order.size();
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i == end) {
+            if (levels) levels->push_back(i);
+            end = order.size();
+        }
+        uint u = order[i];
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            uint v = g.tgt[e];
+            if (!seen.test(v)) {
+                seen.set(v);
+                order.push_back(v);
+            }
+        }
+    }
+    if (levels) levels->push_back(order.size());
+}
+
+// Die starken Zusammenhangskomponenten des Graphen g ermitteln und das
+// Ergebnis als Liste von Listen von Knoten in res speichern (wie scc
+// auf Graph<V>: Kosaraju mit Tiefensuchen auf g und dem transponierten
+// Graphen).
+// Die erste Tiefensuche braucht nur die Abschlussreihenfolge, die
+// zweite nur die Knoten jedes Baums; beide kommen daher mit einem Bit
+// je Knoten aus, und die Intervallvergleiche über det und fin
+// entfallen.
+template <typename V>
+void scc (const FrozenGraph<V>& g, list<list<V>>& res) {
+    uint n = g.size();
+    vector<uint> order, stack;
+    order.reserve(n);
+    Bitset seen(n);
+    DfsStack frames;
+    for (uint r = 0; r < n; r++) {
+        if (seen.test(r)) continue;
+        seen.set(r);
+        frames.push_back({ r, g.off[r] });
+        while (!frames.empty()) {
+            uint v = frames.back().first;
+            uint& e = frames.back().second;
+            if (e < g.off[v + 1]) {
+                uint w = g.tgt[e++];
+                if (!seen.test(w)) {
+                    seen.set(w);
+                    frames.push_back({ w, g.off[w] });
+                }
+                continue;
+            }
+            frames.pop_back();
+            order.push_back(v);
+        }
+    }
+
+    // Zweiter Durchlauf auf dem transponierten Graphen nach absteigenden
+    // Abschlusszeiten; jeder Baum ist eine Komponente. Vom transponierten
+    // Graphen werden nur off und tgt gebraucht und hier aufgebaut
+    // (transpose würde auch Knoten, Indextabelle und Gewichte kopieren).
+    // Innerhalb eines Baums genügt ein einfacher Keller, weil die
+    // Reihenfolge dort keine Rolle spielt.
+    vector<uint> toff(n + 1, 0), ttgt(g.edges());
+    for (uint e = 0; e < g.edges(); e++) toff[g.tgt[e] + 1]++;
+    for (uint v = 0; v < n; v++) toff[v + 1] += toff[v];
+    vector<uint> pos(toff.begin(), toff.end() - 1);
+    for (uint u = 0; u < n; u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) ttgt[pos[g.tgt[e]]++] = u;
+    }
+
+    seen.assign(n);
+    for (size_t i = n; i-- > 0; ) {
+        uint r = order[i];
+        if (seen.test(r)) continue;
+        list<V> l;
+        seen.set(r);
+        stack.push_back(r);
+        while (!stack.empty()) {
+            uint v = stack.back();
+            stack.pop_back();
+            l.push_back(g.vs[v]);
+            for (uint e = toff[v]; e < toff[v + 1]; e++) {
+                uint w = ttgt[e];
+                if (!seen.test(w)) {
+                    seen.set(w);
+                    stack.push_back(w);
+                }
+            }
+        }
+        res.push_front(l);
+    }
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>	// pair
+#include <vector>
+
+#include "graph.h"
+#include "components.h"
+#include "csr.h"
+
+/*
+ *  Wege mit maximaler Engstelle
+ */
+
+// Die Breite eines Weges ist das kleinste Gewicht (etwa die kleinste
+// Kapazität) seiner Kanten; gesucht sind Wege mit maximaler Breite.
+// Der leere Weg von s nach s hat die Breite unendlich, nicht
+// erreichbare Knoten haben die Breite minus unendlich.
+// Wie bei Dijkstra steht die Breite eines Knotens fest, sobald er mit
+// der größten Breite aller noch offenen Knoten entnommen wird; statt
+// d + w wird min(d, w) gebildet und statt des Minimums das Maximum
+// entnommen. Negative Gewichte sind daher erlaubt.
+
+// Wege maximaler Breite vom Startknoten s zu allen Knoten des Graphen
+// g ermitteln und das Ergebnis in res speichern (dist[v] ist die
+// Breite, pred[v] der Vorgänger auf einem breitesten Weg).
+template <typename V, typename G>
+void widestPath (G g, V s, SP<V>& res) {
+    const double inf = numeric_limits<double>::infinity();
+    PrioQueue<double, V, true> q;
+    map<V, Entry<double, V>*> entries;
+    for (auto v : g.vertices()) {
+        res.dist[v] = v == s ? inf : -inf;
+        res.pred[v] = res.NIL;
+        entries[v] = q.insert(res.dist[v], v);
+    }
+
+    while (!q.isEmpty()) {
+        V u = q.extractMinimum()->data;
+        if (res.dist[u] == -inf) break;
+        for (auto v : g.successors(u)) {
+            double w = min(res.dist[u], g.weight(u, v));
+            Entry<double, V>* e = entries[v];
+            if (w > res.dist[v] && q.contains(e)) {
+                res.dist[v] = w;
+                res.pred[v] = u;
+                q.changePrio(e, w);
+            }
+        }
+    }
+    for (auto& p : entries) delete p.second;
+}
+
+// Vergleich für die Max-Halde von widestPath auf einem FrozenGraph.
+struct HeapLess {
+    bool operator() (const pair<double, uint>& a,
+                     const pair<double, uint>& b) const {
+        return a.first < b.first;
+    }
+};
+
+// Wege maximaler Breite vom Startknoten s (Index) im Graphen g
+// ermitteln und das Ergebnis in ws speichern (wie dijkstra, aber mit
+// Breiten in ws.dist; nicht erreichte Knoten sind nicht ws.seen).
+// Wenn ein Zielknoten t angegeben ist, wird die Suche abgebrochen,
+// sobald die Breite von t feststeht.
+// ws.queue enthält danach alle erledigten Knoten nach absteigender
+// Breite.
+template <typename V>
+void widestPath (const FrozenGraph<V>& g, uint s, Workspace& ws,
+                 uint t = NONE) {
+    ws.reset(g.size());
+    ws.set(s, numeric_limits<double>::infinity(), NONE);
+    ws.heap.push_back({ ws.dist[s], s });
+
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), HeapLess());
+        double d = ws.heap.back().first;
+        uint u = ws.heap.back().second;
+        ws.heap.pop_back();
+        if (d < ws.dist[u]) continue;
+        ws.queue.push_back(u);
+        if (u == t) return;
+
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            uint v = g.tgt[e];
+            double w = min(d, g.weight(e));
+            if (!ws.seen(v) || w > ws.dist[v]) {
+                ws.set(v, w, u);
+                ws.heap.push_back({ w, v });
+                push_heap(ws.heap.begin(), ws.heap.end(), HeapLess());
+            }
+        }
+    }
+}
+
+/*
+ *  Engstellen zwischen allen Knotenpaaren
+ */
+
+// Index für Anfragen "Breite eines breitesten Weges zwischen u und v"
+// in einem ungerichteten Graphen.
+// In einem maximalen Spannwald gibt es zwischen je zwei Knoten einer
+// Komponente genau einen Weg, und dieser ist ein breitester Weg im
+// ganzen Graphen. Die Breite ist also die kleinste Kante auf dem
+// Baumweg über den niedrigsten gemeinsamen Vorfahren (LCA) von u und v.
+// Für das Aufsteigen in Zweierpotenzschritten speichert der Index je
+// Stufe k den 2^k-ten Vorfahren up[k][v] und die kleinste Kante low[k][v]
+// auf dem Weg dorthin; eine Anfrage kostet damit O(log n).
+struct BottleneckIndex {
+    vector<uint> depth, root;
+    vector<vector<uint>> up;
+    vector<vector<double>> low;
+
+    // Breite eines breitesten Weges zwischen u und v (Indizes).
+    double width (uint u, uint v) const {
+        const double inf = numeric_limits<double>::infinity();
+        if (u == v) return inf;
+        if (root[u] != root[v]) return -inf;
+        if (depth[u] < depth[v]) swap(u, v);
+        double w = inf;
+        for (uint k = up.size(); k-- > 0; ) {
+            if (depth[u] - depth[v] >= (1u << k)) {
+                w = min(w, low[k][u]);
+                u = up[k][u];
+            }
+        }
+        if (u == v) return w;
+        for (uint k = up.size(); k-- > 0; ) {
+            if (up[k][u] != up[k][v]) {
+                w = min(w, min(low[k][u], low[k][v]));
+                u = up[k][u];
+                v = up[k][v];
+            }
+        }
+        return min(w, min(low[0][u], low[0][v]));
+    }
+};
+
+// Index für den ungerichteten Graphen g (jede Kante in beiden
+// Richtungen mit dem gleichen Gewicht vorhanden) aufbauen und in idx
+// speichern.
+// Ablauf:
+// 1. Maximaler Spannwald mit Kruskal: Kanten nach absteigendem Gewicht
+//    sortieren und jede Kante übernehmen, die zwei verschiedene Mengen
+//    der UnionFind-Struktur verbindet.
+// 2. Jeden Baum von seinem kleinsten Knoten aus per Breitensuche
+//    wurzeln (Vater, Tiefe, Gewicht der Kante zum Vater).
+// 3. Die Tabellen up und low stufenweise verdoppeln.
+template <typename V>
+void buildBottleneck (const FrozenGraph<V>& g, BottleneckIndex& idx) {
+    uint n = g.size();
+    vector<pair<double, pair<uint, uint>>> edges;
+    for (uint u = 0; u < n; u++) {
+        for (uint e = g.off[u]; e < g.off[u + 1]; e++) {
+            if (u < g.tgt[e]) edges.push_back({ g.weight(e), { u, g.tgt[e] } });
+        }
+    }
+    sort(edges.begin(), edges.end(),
+         [] (const pair<double, pair<uint, uint>>& a,
+             const pair<double, pair<uint, uint>>& b) {
+             return a.first > b.first;
+         });
+
+    UnionFind uf(n);
+    vector<uint> toff(n + 1, 0);
+    vector<pair<uint, double>> tadj;
+    vector<pair<double, pair<uint, uint>>> tree;
+    for (auto& e : edges) {
+        if (uf.unite(e.second.first, e.second.second)) tree.push_back(e);
+    }
+    for (auto& e : tree) {
+        toff[e.second.first + 1]++;
+        toff[e.second.second + 1]++;
+    }
+    for (uint v = 0; v < n; v++) toff[v + 1] += toff[v];
+    tadj.resize(toff[n]);
+    vector<uint> pos(toff.begin(), toff.end() - 1);
+    for (auto& e : tree) {
+        tadj[pos[e.second.first]++] = { e.second.second, e.first };
+        tadj[pos[e.second.second]++] = { e.second.first, e.first };
+    }
+
+    uint levels = 1;
+    while ((1u << levels) < n) levels++;
+    idx.depth.assign(n, 0);
+    idx.root.assign(n, NONE);
+    idx.up.assign(levels, vector<uint>(n));
+    idx.low.assign(levels, vector<double>(n, numeric_limits<double>::infinity()));
+    vector<uint> queue;
+    for (uint r = 0; r < n; r++) {
+        if (idx.root[r] != NONE) continue;
+        idx.root[r] = r;
+        idx.up[0][r] = r;
+        queue.assign(1, r);
+        for (size_t i = 0; i < queue.size(); i++) {
+            uint u = queue[i];
+            for (uint x = toff[u]; x < toff[u + 1]; x++) {
+                uint v = tadj[x].first;
+                if (idx.root[v] != NONE) continue;
+                idx.root[v] = r;
+                idx.depth[v] = idx.depth[u] + 1;
+                idx.up[0][v] = u;
+                idx.low[0][v] = tadj[x].second;
+                queue.push_back(v);
+            }
+        }
+    }
+
+    for (uint k = 1; k < levels; k++) {
+        for (uint v = 0; v < n; v++) {
+            uint m = idx.up[k - 1][v];
+            idx.up[k][v] = idx.up[k - 1][m];
+            idx.low[k][v] = min(idx.low[k - 1][v], idx.low[k - 1][m]);
+        }
+    }
+}